@@ -0,0 +1,124 @@
+#pragma once
+
+#include "../JuceHeader.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * KickBiquad - Allocation-free second-order IIR section
+ *
+ * Value type with the normalised coefficients stored inline, so designing, copying and updating a
+ * filter never touches the heap (unlike juce::dsp::IIR::Coefficients, which is ref-counted and
+ * allocated on every make* call). Processing is transposed direct form II.
+ *
+ * The designs match juce::dsp::IIR::Coefficients::makeHighPass/makeLowPass (bilinear transform of
+ * the analogue prototypes, the RBJ cookbook filters) but are computed in double precision.
+ *
+ * SampleType may be float, double or a juce::dsp::SIMDRegister to run several independent
+ * channels of the same filter in one register.
+ */
+template <typename SampleType>
+class KickBiquad
+{
+public:
+    using NumericType = typename juce::dsp::SampleTypeHelpers::ElementType<SampleType>::Type;
+
+    struct Coefficients
+    {
+        // y = b0 x + b1 x[-1] + b2 x[-2] - a1 y[-1] - a2 y[-2]
+        SampleType b0 = SampleType(1);
+        SampleType b1 = SampleType(0);
+        SampleType b2 = SampleType(0);
+        SampleType a1 = SampleType(0);
+        SampleType a2 = SampleType(0);
+
+        // Cutoffs at or above Nyquist wrap tan(pi f / fs) negative and the sections go unstable, so
+        // callers whose cutoff can exceed it (parameters set for 48 kHz rendered at a lower rate)
+        // limit it to 0.45 fs first
+        static double limitCutoff(double sampleRate, double frequency)
+        {
+            return std::min(frequency, sampleRate * 0.45);
+        }
+
+        static Coefficients makeHighPass(double sampleRate, double frequency,
+                                         double q = juce::MathConstants<double>::sqrt2 * 0.5)
+        {
+            const double n = std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+            const double nSquared = n * n;
+            const double invQ = 1.0 / q;
+            const double c1 = 1.0 / (1.0 + invQ * n + nSquared);
+            return make(c1, c1 * -2.0, c1, c1 * 2.0 * (nSquared - 1.0), c1 * (1.0 - invQ * n + nSquared));
+        }
+
+        static Coefficients makeLowPass(double sampleRate, double frequency,
+                                        double q = juce::MathConstants<double>::sqrt2 * 0.5)
+        {
+            const double n = 1.0 / std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+            const double nSquared = n * n;
+            const double invQ = 1.0 / q;
+            const double c1 = 1.0 / (1.0 + invQ * n + nSquared);
+            return make(c1, c1 * 2.0, c1, c1 * 2.0 * (1.0 - nSquared), c1 * (1.0 - invQ * n + nSquared));
+        }
+
+    private:
+        static Coefficients make(double b0, double b1, double b2, double a1, double a2)
+        {
+            Coefficients c;
+            c.b0 = SampleType(static_cast<NumericType>(b0));
+            c.b1 = SampleType(static_cast<NumericType>(b1));
+            c.b2 = SampleType(static_cast<NumericType>(b2));
+            c.a1 = SampleType(static_cast<NumericType>(a1));
+            c.a2 = SampleType(static_cast<NumericType>(a2));
+            return c;
+        }
+    };
+
+    KickBiquad() = default;
+    explicit KickBiquad(const Coefficients& newCoefficients) : coefficients(newCoefficients) {}
+
+    // Updates the response without clearing the state (safe to call while running)
+    void setCoefficients(const Coefficients& newCoefficients) { coefficients = newCoefficients; }
+    const Coefficients& getCoefficients() const { return coefficients; }
+
+    void reset()
+    {
+        s1 = SampleType(0);
+        s2 = SampleType(0);
+    }
+
+    SampleType processSample(SampleType input)
+    {
+        const SampleType output = coefficients.b0 * input + s1;
+        s1 = coefficients.b1 * input - coefficients.a1 * output + s2;
+        s2 = coefficients.b2 * input - coefficients.a2 * output;
+        return output;
+    }
+
+    // Block form: coefficients and state stay in registers for the whole loop
+    void processBlock(const SampleType* input, SampleType* output, int numSamples)
+    {
+        const auto c = coefficients;
+        SampleType z1 = s1, z2 = s2;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const SampleType x = input[i];
+            const SampleType y = c.b0 * x + z1;
+            z1 = c.b1 * x - c.a1 * y + z2;
+            z2 = c.b2 * x - c.a2 * y;
+            output[i] = y;
+        }
+
+        juce::dsp::util::snapToZero(z1);
+        juce::dsp::util::snapToZero(z2);
+        s1 = z1;
+        s2 = z2;
+    }
+
+    void processBlock(SampleType* samples, int numSamples) { processBlock(samples, samples, numSamples); }
+
+private:
+    Coefficients coefficients;
+    SampleType s1 = SampleType(0);
+    SampleType s2 = SampleType(0);
+};
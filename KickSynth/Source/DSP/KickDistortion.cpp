@@ -1,6 +1,31 @@
 #include "KickDistortion.h"
 #include <cmath>
 
+namespace
+{
+    constexpr double ln2 = 0.69314718055994530942;
+
+    // Slopes of the asymmetric shaper: tanh(kPos * x) for x > 0, tanh(kNeg * x) otherwise
+    double asymmetricSlope(double x, float asymmetry)
+    {
+        const double asymAmount = (double)asymmetry * 0.5;
+        return x > 0.0 ? 1.0 + asymAmount : 1.0 - asymAmount * 2.0;
+    }
+
+    // Li2(w) for 0 <= w <= 1/2 from u = -ln(1 - w), using the Bernoulli series
+    // Li2 = sum B_n u^(n+1) / (n+1)!, which converges fast for u <= ln 2
+    double dilogFromLog(double u)
+    {
+        const double u2 = u * u;
+        const double series = 1.0 / 36.0
+                            + u2 * (-1.0 / 3600.0
+                            + u2 * (1.0 / 211680.0
+                            + u2 * (-1.0 / 10886400.0
+                            + u2 * (1.0 / 526901760.0))));
+        return u - 0.25 * u2 + u * u2 * series;
+    }
+}
+
 KickDistortion::KickDistortion()
 {
 }
@@ -12,75 +37,292 @@ void KickDistortion::prepare(double sampleRate, int samplesPerBlock)
 
 void KickDistortion::reset()
 {
+    history1 = 0.0;
+    history2 = 0.0;
+    historyF1 = 0.0;
+    historyF2 = 0.0;
+    historyD = 0.0;
+    historyType = -1;
+}
+
+void KickDistortion::setAntialiasing(int order)
+{
+    order = juce::jlimit(0, 2, order);
+    if (order == antialiasing)
+        return;
+
+    antialiasing = order;
+    reset();
+}
+
+template <size_t... Index>
+constexpr std::array<KickDistortion::SampleKernel, sizeof...(Index)> KickDistortion::makeSampleKernels(std::index_sequence<Index...>)
+{
+    return {{ &KickDistortion::processSampleKernel<(int)(Index / 3), (int)(Index % 3)>... }};
+}
+
+template <size_t... Index>
+constexpr std::array<KickDistortion::BlockKernel, sizeof...(Index)> KickDistortion::makeBlockKernels(std::index_sequence<Index...>)
+{
+    return {{ &KickDistortion::processBlockKernel<(int)(Index / 3), (int)(Index % 3)>... }};
 }
 
 float KickDistortion::processSample(float input)
 {
-    if (drive <= 0.000001f)
-        return input;
+    static constexpr auto kernels = makeSampleKernels(std::make_index_sequence<numKernels>());
+    return (this->*kernels[(size_t)getKernelIndex()])(input);
+}
 
-    // Map drive: 0-1 -> 1-10x
-    const float driveAmount = 1.0f + drive * 9.0f;
-    const float driven = input * driveAmount;
-    
-    // Apply distortion
-    float output = 0.0f;
-    if (distortionType == 0) // Tanh soft clip
-    {
-        output = tanhSoftClip(driven);
-    }
-    else if (distortionType == 1) // Hard clip
-    {
-        output = hardClip(driven);
-    }
-    else // Asymmetric soft clip
+void KickDistortion::processBlock(float* samples, int numSamples, const float* driveValues, const float* asymmetryValues)
+{
+    static constexpr auto kernels = makeBlockKernels(std::make_index_sequence<numKernels>());
+    (this->*kernels[(size_t)getKernelIndex()])(samples, numSamples, driveValues, asymmetryValues);
+}
+
+template <int Type, int Antialiasing>
+float KickDistortion::processSampleKernel(float input)
+{
+    if (drive <= 0.000001f)
     {
-        output = asymmetricSoftClip(driven);
+        if constexpr (Antialiasing > 0)
+            pushBypassedSample(input);
+        return input;
     }
-    
-    return output;
+
+    return shapeDriven<Type, Antialiasing>(input * driveGain(drive));
 }
 
-void KickDistortion::processBlock(juce::AudioBuffer<float>& buffer)
+template <int Type, int Antialiasing>
+void KickDistortion::processBlockKernel(float* samples, int numSamples, const float* driveValues, const float* asymmetryValues)
 {
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    if (driveValues != nullptr || asymmetryValues != nullptr)
     {
-        auto* channelData = buffer.getWritePointer(channel);
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+        for (int sample = 0; sample < numSamples; ++sample)
         {
-            channelData[sample] = processSample(channelData[sample]);
+            if (driveValues != nullptr)
+                drive = driveValues[sample];
+            if (asymmetryValues != nullptr)
+                asymmetry = asymmetryValues[sample];
+            samples[sample] = processSampleKernel<Type, Antialiasing>(samples[sample]);
         }
+        return;
     }
+
+    // Settled drive: bypass or the drive mapping is decided once for the block
+    if (drive <= 0.000001f)
+    {
+        if constexpr (Antialiasing > 0)
+            for (int sample = 0; sample < numSamples; ++sample)
+                pushBypassedSample(samples[sample]);
+        return;
+    }
+
+    const float driveAmount = driveGain(drive);
+    for (int sample = 0; sample < numSamples; ++sample)
+        samples[sample] = shapeDriven<Type, Antialiasing>(samples[sample] * driveAmount);
+}
+
+template <int Type, int Antialiasing>
+float KickDistortion::shapeDriven(float driven)
+{
+    if constexpr (Antialiasing == 1)
+        return processFirstOrder<Type>(driven);
+    else if constexpr (Antialiasing == 2)
+        return processSecondOrder<Type>(driven);
+    else if constexpr (Type == 0) // Tanh soft clip
+        return tanhSoftClip(driven);
+    else if constexpr (Type == 1) // Hard clip
+        return hardClip(driven);
+    else // Asymmetric soft clip
+        return asymmetricSoftClip(driven);
 }
 
 float KickDistortion::tanhSoftClip(float input)
 {
-    // Soft clipping using tanh
-    return std::tanh(input);
+    return transfer<0>(input, asymmetry);
 }
 
 float KickDistortion::asymmetricSoftClip(float input)
 {
-    // Asymmetric soft clipping
-    // Map asymmetry: 0-1 -> 0-0.5
-    float asymAmount = asymmetry * 0.5f;
-    
-    if (input > 0.0f)
+    return transfer<2>(input, asymmetry);
+}
+
+float KickDistortion::hardClip(float input)
+{
+    return transfer<1>(input, asymmetry);
+}
+
+
+
+
+//==============================================================================
+// Antiderivative anti-aliasing
+
+template <int Type>
+float KickDistortion::processFirstOrder(double input)
+{
+    refreshHistory<Type>();
+
+    const double f1 = antiderivative1<Type>(input);
+    const double delta = input - history1;
+
+    double output = 0.0;
+    if (std::abs(delta) < firstOrderTolerance)
+        output = shape<Type>(0.5 * (input + history1));
+    else
+        output = (f1 - historyF1) / delta;
+
+    history2 = history1;
+    history1 = input;
+    historyF1 = f1;
+    return (float)output;
+}
+
+template <int Type>
+float KickDistortion::processSecondOrder(double input)
+{
+    refreshHistory<Type>();
+
+    const double f2 = antiderivative2<Type>(input);
+    const double d = dividedDifference<Type>(input, history1, f2, historyF2);
+
+    double output = 0.0;
+    if (std::abs(input - history2) < secondOrderTolerance)
     {
-        // Positive: tanh with slight asymmetry
-        return std::tanh(input * (1.0f + asymAmount));
+        // x[n] ~ x[n-2]: expand around their midpoint instead of dividing by their difference
+        const double xBar = 0.5 * (input + history2);
+        const double delta = xBar - history1;
+        if (std::abs(delta) < secondOrderTolerance)
+            output = shape<Type>(0.5 * (xBar + history1));
+        else
+            output = (2.0 / delta) * (antiderivative1<Type>(xBar) + (historyF2 - antiderivative2<Type>(xBar)) / delta);
     }
     else
     {
-        // Negative: more aggressive clipping
-        return std::tanh(input * (1.0f - asymAmount * 2.0f));
+        output = 2.0 * (d - historyD) / (input - history2);
     }
+
+    history2 = history1;
+    history1 = input;
+    historyF2 = f2;
+    historyD = d;
+    return (float)output;
 }
 
-float KickDistortion::hardClip(float input)
+void KickDistortion::pushBypassedSample(double input)
+{
+    // Keep the input history continuous through the bypass; the cached terms are recomputed on
+    // the next shaped sample
+    history2 = history1;
+    history1 = input;
+    historyType = -1;
+}
+
+template <int Type>
+void KickDistortion::refreshHistory()
+{
+    if (historyType == Type && (Type != 2 || historyAsymmetry == asymmetry))
+        return;
+
+    // The shaper changed: the cached antiderivatives belong to the old one and would turn the
+    // differences into garbage, so recompute them for the stored inputs
+    historyType = Type;
+    historyAsymmetry = asymmetry;
+    historyF1 = antiderivative1<Type>(history1);
+    historyF2 = antiderivative2<Type>(history1);
+    historyD = dividedDifference<Type>(history1, history2, historyF2, antiderivative2<Type>(history2));
+}
+
+template <int Type>
+double KickDistortion::dividedDifference(double x0, double x1, double f2x0, double f2x1) const
+{
+    const double delta = x0 - x1;
+    if (std::abs(delta) < secondOrderTolerance)
+        return antiderivative1<Type>(0.5 * (x0 + x1));
+    return (f2x0 - f2x1) / delta;
+}
+
+template <int Type>
+double KickDistortion::shape(double x) const
 {
-    return juce::jlimit(-1.0f, 1.0f, input);
+    return transfer<Type>(x, (double)asymmetry);
 }
 
+template <int Type>
+double KickDistortion::antiderivative1(double x) const
+{
+    if constexpr (Type == 0)
+        return tanhAntiderivative1(x);
+    if constexpr (Type == 1)
+        return hardClipAntiderivative1(x);
+
+    // F1 = logcosh(k x) / k, which tends to k x^2 / 2 as k -> 0 (full asymmetry flattens the
+    // negative side)
+    const double k = asymmetricSlope(x, asymmetry);
+    if (std::abs(k) < 1.0e-6)
+        return 0.5 * k * x * x;
+    return tanhAntiderivative1(k * x) / k;
+}
 
+template <int Type>
+double KickDistortion::antiderivative2(double x) const
+{
+    if constexpr (Type == 0)
+        return tanhAntiderivative2(x);
+    if constexpr (Type == 1)
+        return hardClipAntiderivative2(x);
+
+    const double k = asymmetricSlope(x, asymmetry);
+    if (std::abs(k) < 1.0e-6)
+        return k * x * x * x / 6.0;
+    return tanhAntiderivative2(k * x) / (k * k);
+}
 
+double KickDistortion::tanhAntiderivative1(double x)
+{
+    // log(cosh(x)), written to avoid overflow for large |x| and cancellation for small |x|
+    const double ax = std::abs(x);
+    if (ax < 1.0)
+    {
+        const double s = std::sinh(0.5 * x);
+        return std::log1p(2.0 * s * s);
+    }
+    return ax - ln2 + std::log1p(std::exp(-2.0 * ax));
+}
+
+double KickDistortion::tanhAntiderivative2(double x)
+{
+    // Odd antiderivative of log(cosh(x)). For x >= 0:
+    //   F2 = x^2/2 - x ln2 + Li2(-e^(-2x))/2 + pi^2/24
+    // with Li2(z) = -Li2(z / (z - 1)) - ln^2(1 - z)/2 (Landen) bringing the argument into [0, 1/2].
+    const double ax = std::abs(x);
+    double result = 0.0;
+    if (ax < 0.05)
+    {
+        const double x2 = ax * ax;
+        result = ax * x2 * (1.0 / 6.0 - x2 / 60.0);
+    }
+    else
+    {
+        const double u = std::log1p(std::exp(-2.0 * ax)); // -ln(1 - w), w = e^-2x / (1 + e^-2x)
+        const double li2 = -dilogFromLog(u) - 0.5 * u * u; // Li2(-e^-2x)
+        result = 0.5 * ax * ax - ln2 * ax + 0.5 * li2
+               + juce::MathConstants<double>::pi * juce::MathConstants<double>::pi / 24.0;
+    }
+    return x < 0.0 ? -result : result;
+}
+
+double KickDistortion::hardClipAntiderivative1(double x)
+{
+    const double ax = std::abs(x);
+    return ax <= 1.0 ? 0.5 * x * x : ax - 0.5;
+}
+
+double KickDistortion::hardClipAntiderivative2(double x)
+{
+    if (x > 1.0)
+        return 0.5 * x * x - 0.5 * x + 1.0 / 6.0;
+    if (x < -1.0)
+        return -0.5 * x * x - 0.5 * x - 1.0 / 6.0;
+    return x * x * x / 6.0;
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../JuceHeader.h"
+#include <array>
+#include <utility>
 
 /**
  * KickDistortion - Distortion module for kick synthesis
@@ -9,6 +11,18 @@
  * - 0: Tanh soft clip
  * - 1: Hard clip (simple threshold)
  * - 2: Asymmetric soft clip
+ *
+ * Antialiasing (antiderivative anti-aliasing, no oversampling and no lookahead):
+ * - 0: Off
+ * - 1: First-order ADAA, y = (F1(x[n]) - F1(x[n-1])) / (x[n] - x[n-1]); half a sample of delay
+ * - 2: Second-order ADAA on the divided differences of F2; one sample of delay
+ *
+ * F1/F2 are the closed-form first and second antiderivatives of each shaper, evaluated in double
+ * precision. When consecutive inputs get too close for the differences to be well conditioned the
+ * shaper (or F1) is evaluated at the midpoint instead.
+ *
+ * Processing runs through kernels specialised at compile time on (type, antialiasing order), picked
+ * once per block; with settled drive the drive mapping is also hoisted out of the loop.
  */
 class KickDistortion
 {
@@ -22,18 +36,100 @@ public:
     // Process single sample
     float processSample(float input);
     
-    // Process buffer
-    void processBlock(juce::AudioBuffer<float>& buffer);
+    // Process a mono block in place; optional per-sample drive/asymmetry ramps (nullptr = settled)
+    void processBlock(float* samples, int numSamples,
+                      const float* driveValues = nullptr, const float* asymmetryValues = nullptr);
     
     // Parameters
-    void setDistortionType(int type) { distortionType = type; }
+    void setDistortionType(int type) { distortionType = juce::jlimit(0, 2, type); }
     void setDrive(float driveValue) { drive = driveValue; } // 0-1, maps to 1-10x
     void setAsymmetry(float asymmetryValue) { asymmetry = asymmetryValue; } // 0-1, maps to 0-0.5
+    void setAntialiasing(int order); // 0=off, 1=first-order ADAA, 2=second-order ADAA
+    
+    // Drive mapping and shaper curves for any arithmetic type: processing runs them in float and
+    // double (the ADAA paths integrate the same curves), kick_fit's gradient model on dual numbers
+    template <typename T>
+    static T driveGain(T driveValue) { return T(1.0f) + driveValue * T(9.0f); } // 0-1 -> 1-10x
+    
+    template <int Type, typename T>
+    static T transfer(T driven, T asymmetryValue)
+    {
+        using std::tanh;
+        if constexpr (Type == 0) // Tanh soft clip
+        {
+            return tanh(driven);
+        }
+        else if constexpr (Type == 1) // Hard clip
+        {
+            return driven < T(-1.0f) ? T(-1.0f) : (T(1.0f) < driven ? T(1.0f) : driven);
+        }
+        else // Asymmetric soft clip: asymmetry 0-1 maps to 0-0.5, the negative side clips harder
+        {
+            const T asymAmount = asymmetryValue * T(0.5f);
+            return driven > T(0.0f) ? tanh(driven * (T(1.0f) + asymAmount))
+                                    : tanh(driven * (T(1.0f) - asymAmount * T(2.0f)));
+        }
+    }
     
 private:
     int distortionType = 0; // 0=tanh, 1=hard, 2=asymmetric
     float drive = 0.5f; // 0-1
     float asymmetry = 0.0f; // 0-1
+    int antialiasing = 0; // 0=off, 1=ADAA1, 2=ADAA2
+    
+    // ADAA state: previous driven inputs and the antiderivative terms derived from them. The cached
+    // terms are only valid for the shaper they were computed with (type + asymmetry).
+    double history1 = 0.0; // x[n-1]
+    double history2 = 0.0; // x[n-2]
+    double historyF1 = 0.0; // F1(x[n-1])
+    double historyF2 = 0.0; // F2(x[n-1])
+    double historyD = 0.0; // (F2(x[n-1]) - F2(x[n-2])) / (x[n-1] - x[n-2])
+    int historyType = -1;
+    float historyAsymmetry = 0.0f;
+    
+    static constexpr double firstOrderTolerance = 1.0e-5;
+    static constexpr double secondOrderTolerance = 1.0e-4;
+    
+    // Kernels per (type, antialiasing order), indexed type * 3 + order
+    using SampleKernel = float (KickDistortion::*)(float);
+    using BlockKernel = void (KickDistortion::*)(float*, int, const float*, const float*);
+    static constexpr int numKernels = 9;
+    
+    template <int Type, int Antialiasing>
+    float processSampleKernel(float input);
+    template <int Type, int Antialiasing>
+    void processBlockKernel(float* samples, int numSamples, const float* driveValues, const float* asymmetryValues);
+    template <int Type, int Antialiasing>
+    float shapeDriven(float driven);
+    
+    template <size_t... Index>
+    static constexpr std::array<SampleKernel, sizeof...(Index)> makeSampleKernels(std::index_sequence<Index...>);
+    template <size_t... Index>
+    static constexpr std::array<BlockKernel, sizeof...(Index)> makeBlockKernels(std::index_sequence<Index...>);
+    int getKernelIndex() const { return distortionType * 3 + antialiasing; }
+    
+    template <int Type>
+    float processFirstOrder(double input);
+    template <int Type>
+    float processSecondOrder(double input);
+    void pushBypassedSample(double input);
+    template <int Type>
+    void refreshHistory();
+    template <int Type>
+    double dividedDifference(double x0, double x1, double f2x0, double f2x1) const;
+    
+    // Shaper and its antiderivatives per type, in double precision
+    template <int Type>
+    double shape(double x) const;
+    template <int Type>
+    double antiderivative1(double x) const;
+    template <int Type>
+    double antiderivative2(double x) const;
+    
+    static double tanhAntiderivative1(double x);
+    static double tanhAntiderivative2(double x);
+    static double hardClipAntiderivative1(double x);
+    static double hardClipAntiderivative2(double x);
     
     float hardClip(float input);
     // Tanh soft clip
@@ -42,4 +138,3 @@ private:
     // Asymmetric soft clip
     float asymmetricSoftClip(float input);
 };
-
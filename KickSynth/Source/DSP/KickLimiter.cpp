@@ -1,51 +1,201 @@
 #include "KickLimiter.h"
+#include <algorithm>
 #include <cmath>
 
 KickLimiter::KickLimiter()
 {
+    interpolationKernels = sharedResources->getTable<InterpolationKernels>("KickLimiter.truePeak", &makeInterpolationKernels);
+}
+
+KickLimiter::InterpolationKernels KickLimiter::makeInterpolationKernels()
+{
+    // Windowed-sinc kernels for the 4x true-peak estimate (samples n-7..n, value between n-4 and n-3)
+    InterpolationKernels kernels{};
+    for (int phase = 1; phase < truePeakOversampling; ++phase)
+    {
+        const double frac = (double)phase / (double)truePeakOversampling;
+        double sum = 0.0;
+        for (int k = 0; k < truePeakTaps; ++k)
+        {
+            const double t = (double)(k - (truePeakTaps - 1 - truePeakDelay)) - frac;
+            const double sinc = std::abs(t) < 1.0e-9 ? 1.0 : std::sin(juce::MathConstants<double>::pi * t)
+                                                           / (juce::MathConstants<double>::pi * t);
+            const double x = t / (0.5 * truePeakTaps + 1.0);
+            const double window = std::cos(0.5 * juce::MathConstants<double>::pi * x);
+            const double h = sinc * window * window;
+            kernels[(size_t)phase - 1][(size_t)(truePeakTaps - 1 - k)] = (float)h;
+            sum += h;
+        }
+
+        // Normalise DC gain
+        for (auto& h : kernels[(size_t)phase - 1])
+            h = (float)(h / sum);
+    }
+
+    return kernels;
 }
 
 void KickLimiter::prepare(double sampleRate, int samplesPerBlock)
 {
+    juce::ignoreUnused(samplesPerBlock);
+    currentSampleRate = sampleRate;
+
+    lookaheadSamples = std::max(1, (int)std::round(lookaheadMs * 0.001 * sampleRate));
+    ceilingGain = juce::Decibels::decibelsToGain(ceilingDb);
+    releaseCoeff = (float)(1.0 - std::exp(-1.0 / (releaseMs * 0.001 * sampleRate)));
+
+    // The peak hold spans one sample more than the averaging window so that both samples around an
+    // inter-sample peak are covered.
+    dequeValues.assign((size_t)lookaheadSamples + 2, 0.0f);
+    dequeIndices.assign((size_t)lookaheadSamples + 2, 0);
+    averageWindow.assign((size_t)lookaheadSamples, 1.0f);
+    delayLine.assign((size_t)(lookaheadSamples + truePeakDelay - 1), 0.0f);
+
     reset();
 }
 
 void KickLimiter::reset()
 {
+    detectorHistory.fill(0.0f);
+    detectorPos = 0;
+
+    dequeHead = 0;
+    dequeSize = 0;
+    sampleIndex = 0;
+
+    releasedGain = 1.0f;
+    std::fill(averageWindow.begin(), averageWindow.end(), 1.0f);
+    averagePos = 0;
+    averageSum = (double)averageWindow.size();
+
+    std::fill(delayLine.begin(), delayLine.end(), 0.0f);
+    delayPos = 0;
+}
+
+void KickLimiter::setMode(int newMode)
+{
+    newMode = juce::jlimit(0, 1, newMode);
+    if (newMode == mode)
+        return;
+
+    mode = newMode;
+    reset();
 }
 
 float KickLimiter::processSample(float input)
 {
     // Apply gain
     float output = input * outputGainLinear;
-    
+
+    if (mode == 1)
+        return truePeakLimit(output);
+
     // Apply limiter if enabled
     if (limiterEnabled)
     {
         output = softClipLimit(output);
     }
-    
+
     return output;
 }
 
-void KickLimiter::processBlock(juce::AudioBuffer<float>& buffer)
+void KickLimiter::processBlock(float* samples, int numSamples, const float* gainValues)
 {
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    if (gainValues == nullptr)
     {
-        auto* channelData = buffer.getWritePointer(channel);
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-        {
-            channelData[sample] = processSample(channelData[sample]);
-        }
+        for (int sample = 0; sample < numSamples; ++sample)
+            samples[sample] = processSample(samples[sample]);
+        return;
+    }
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        outputGainLinear = gainValues[sample];
+        samples[sample] = processSample(samples[sample]);
     }
 }
 
 float KickLimiter::softClipLimit(float input)
 {
-    // Soft clipping to prevent >0 dBFS.
-    // Monotonic, symmetric, unity-slope at 0.
-    return std::tanh(input);
+    // Soft clipping to prevent >0 dBFS
+    return softClip(input);
 }
 
+float KickLimiter::truePeakLimit(float input)
+{
+    // Delay the audio by the lookahead (the delay line keeps running while disabled so the
+    // reported latency stays constant)
+    const int delayLength = (int)delayLine.size();
+    const float delayed = delayLine[(size_t)delayPos];
+    delayLine[(size_t)delayPos] = input;
+    delayPos = (delayPos + 1) % delayLength;
+
+    const float peak = pushSlidingMax(detectTruePeak(input));
+
+    if (!limiterEnabled)
+        return delayed;
+
+    // Gain needed to keep the held peak under the ceiling; instant attack, smoothed release
+    const float targetGain = peak > ceilingGain ? ceilingGain / peak : 1.0f;
+    if (targetGain < releasedGain)
+        releasedGain = targetGain;
+    else
+        releasedGain += (targetGain - releasedGain) * releaseCoeff;
+
+    // Averaging over the lookahead window turns the instant attack into a ramp that completes
+    // exactly when the peak leaves the delay line
+    averageSum += (double)releasedGain - (double)averageWindow[(size_t)averagePos];
+    averageWindow[(size_t)averagePos] = releasedGain;
+    averagePos = (averagePos + 1) % (int)averageWindow.size();
 
+    const float gain = (float)(averageSum / (double)averageWindow.size());
+    return delayed * std::min(1.0f, gain);
+}
+
+float KickLimiter::detectTruePeak(float input)
+{
+    detectorHistory[(size_t)detectorPos] = input;
+    detectorPos = (detectorPos + 1) % truePeakTaps;
+
+    // Sample peak at n-4 plus the three interpolated positions between n-4 and n-3
+    float peak = std::abs(detectorHistory[(size_t)((detectorPos + truePeakTaps - 1 - truePeakDelay) % truePeakTaps)]);
+    for (const auto& kernel : *interpolationKernels)
+    {
+        float sum = 0.0f;
+        for (int k = 0; k < truePeakTaps; ++k)
+            sum += kernel[(size_t)k] * detectorHistory[(size_t)((detectorPos + truePeakTaps - 1 - k) % truePeakTaps)];
+        peak = std::max(peak, std::abs(sum));
+    }
 
+    return peak;
+}
+
+float KickLimiter::pushSlidingMax(float value)
+{
+    const int capacity = (int)dequeValues.size();
+    const int64_t windowLength = (int64_t)lookaheadSamples + 1;
+
+    // Drop smaller values from the back: they can never be the maximum again
+    while (dequeSize > 0)
+    {
+        const int back = (dequeHead + dequeSize - 1) % capacity;
+        if (dequeValues[(size_t)back] > value)
+            break;
+        --dequeSize;
+    }
+
+    const int slot = (dequeHead + dequeSize) % capacity;
+    dequeValues[(size_t)slot] = value;
+    dequeIndices[(size_t)slot] = sampleIndex;
+    ++dequeSize;
+
+    // Drop expired values from the front
+    while (dequeIndices[(size_t)dequeHead] <= sampleIndex - windowLength)
+    {
+        dequeHead = (dequeHead + 1) % capacity;
+        --dequeSize;
+    }
+
+    ++sampleIndex;
+    return dequeValues[(size_t)dequeHead];
+}
@@ -1,34 +1,106 @@
 #pragma once
 
 #include "../JuceHeader.h"
+#include "SharedResources.h"
+#include <array>
+#include <memory>
+#include <vector>
 
 /**
  * KickLimiter - Output limiter/soft clip to prevent >0 dBFS
+ *
+ * Modes:
+ * - 0: Soft clip (tanh saturation, zero latency)
+ * - 1: True peak (lookahead brickwall limiter with a 4x oversampled peak detector)
+ *
+ * The true-peak mode delays the signal by getLatencySamples(). Its gain is the ceiling over the
+ * sliding maximum of the detected peaks (monotonic deque, O(1) per sample whatever the lookahead),
+ * released with a one-pole smoother and then averaged over the lookahead window so the gain has
+ * fully ramped down by the time a peak leaves the delay line.
  */
 class KickLimiter
 {
 public:
     KickLimiter();
     ~KickLimiter() = default;
-    
+
     void prepare(double sampleRate, int samplesPerBlock);
     void reset();
-    
+
     // Process single sample
     float processSample(float input);
-    
-    // Process buffer
-    void processBlock(juce::AudioBuffer<float>& buffer);
-    
+
+    // Process a mono block in place; optional per-sample linear gain ramp (nullptr = settled)
+    void processBlock(float* samples, int numSamples, const float* gainValues = nullptr);
+
     // Parameters
     void setLimiterEnabled(bool enabled) { limiterEnabled = enabled; }
+    void setMode(int newMode);
     void setOutputGain(float gainDb) { outputGainLinear = juce::Decibels::decibelsToGain(gainDb); }
-    
+    void setOutputGainLinear(float gain) { outputGainLinear = gain; }
+
+    int getMode() const { return mode; }
+
+    // Soft-clip curve for any arithmetic type (kick_fit's gradient model runs it on dual numbers):
+    // monotonic, symmetric, unity slope at 0
+    template <typename T>
+    static T softClip(T input)
+    {
+        using std::tanh;
+        return tanh(input);
+    }
+
+    // Latency introduced by the current mode (0 for soft clip)
+    int getLatencySamples() const { return mode == 1 ? lookaheadSamples + truePeakDelay - 1 : 0; }
+
 private:
+    static constexpr int truePeakOversampling = 4;
+    static constexpr int truePeakTaps = 8;
+    static constexpr int truePeakDelay = truePeakTaps / 2;
+    static constexpr float ceilingDb = -0.3f;
+    static constexpr double lookaheadMs = 1.5;
+    static constexpr double releaseMs = 60.0;
+
     bool limiterEnabled = true;
+    int mode = 0; // 0=soft clip, 1=true peak
     float outputGainLinear = 1.0f;
-    
+    double currentSampleRate = 44100.0;
+
+    // True-peak detector: polyphase interpolation kernels for the fractional positions 1/4..3/4,
+    // shared by every limiter
+    using InterpolationKernels = std::array<std::array<float, truePeakTaps>, truePeakOversampling - 1>;
+    static InterpolationKernels makeInterpolationKernels();
+    juce::SharedResourcePointer<SharedResources> sharedResources;
+    std::shared_ptr<const InterpolationKernels> interpolationKernels;
+    std::array<float, truePeakTaps> detectorHistory{};
+    int detectorPos = 0;
+
+    // Sliding maximum over the detected peaks (monotonic deque in a fixed ring)
+    std::vector<float> dequeValues;
+    std::vector<int64_t> dequeIndices;
+    int dequeHead = 0;
+    int dequeSize = 0;
+    int64_t sampleIndex = 0;
+
+    // Gain smoothing
+    float ceilingGain = 1.0f;
+    float releaseCoeff = 0.0f;
+    float releasedGain = 1.0f;
+    std::vector<float> averageWindow;
+    int averagePos = 0;
+    double averageSum = 0.0;
+
+    // Audio delay line
+    std::vector<float> delayLine;
+    int delayPos = 0;
+
+    int lookaheadSamples = 1;
+
     // Soft clip limiter
     float softClipLimit(float input);
-};
 
+    // Lookahead true-peak limiter
+    float truePeakLimit(float input);
+    float detectTruePeak(float input);
+    float pushSlidingMax(float value);
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/**
+ * KickNoise - Seedable white noise source
+ *
+ * Runs numLanes independent xorshift32 generators side by side so that fill() is a plain
+ * fixed-width loop the compiler turns into SIMD code. The lanes are seeded from one 64-bit seed
+ * through splitmix64, so the same seed always produces the same sequence.
+ *
+ * Output is uniform in [-1, 1).
+ */
+class KickNoise
+{
+public:
+    static constexpr int numLanes = 8;
+
+    explicit KickNoise(uint64_t seed = 1) { setSeed(seed); }
+
+    void setSeed(uint64_t seed)
+    {
+        uint64_t mix = seed;
+        for (auto& lane : state)
+        {
+            // splitmix64; xorshift32 must never be seeded with zero
+            mix += 0x9E3779B97F4A7C15ull;
+            uint64_t z = mix;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            z ^= z >> 31;
+            lane = static_cast<uint32_t>(z) | 1u;
+        }
+    }
+
+    // Writes numSamples noise values; lanes are interleaved sample by sample.
+    void fill(float* dest, int numSamples)
+    {
+        int sample = 0;
+        for (; sample + numLanes <= numSamples; sample += numLanes)
+            nextBlock(dest + sample);
+
+        if (sample < numSamples)
+        {
+            std::array<float, numLanes> tail{};
+            nextBlock(tail.data());
+            for (int lane = 0; sample < numSamples; ++sample, ++lane)
+                dest[sample] = tail[(size_t)lane];
+        }
+    }
+
+private:
+    std::array<uint32_t, numLanes> state{};
+
+    void nextBlock(float* dest)
+    {
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            uint32_t x = state[(size_t)lane];
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            state[(size_t)lane] = x;
+
+            // Top 24 bits -> [0, 1) -> [-1, 1)
+            dest[lane] = static_cast<float>(x >> 8) * (2.0f / 16777216.0f) - 1.0f;
+        }
+    }
+};
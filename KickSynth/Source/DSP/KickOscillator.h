@@ -0,0 +1,104 @@
+#pragma once
+
+#include "../JuceHeader.h"
+#include "KickSampleTraits.h"
+#include <cmath>
+
+/**
+ * KickOscillator - Body waveforms for KickVoice
+ *
+ * Shapes: 0 = sine, 1 = triangle, 2 = saw, 3 = square. Each is evaluated at a phase in [0, 1) for a
+ * phase increment dt (frequency / rate). The triangle's corners get a two-sample PolyBLAMP residual
+ * and the saw/square edges a two-sample PolyBLEP residual, which removes most of the aliasing of the
+ * naive shapes without oversampling (a few multiplies per sample, only near the corners/edges).
+ * Triangle and square are zero-mean; every shape starts at phase 0 on its lowest point or rising edge.
+ */
+struct KickOscillator
+{
+    enum Shape
+    {
+        sine = 0,
+        triangle,
+        saw,
+        square,
+        numShapes
+    };
+
+    // Band-limited sample of a shape; the residuals assume dt < 0.5. T is float in the voice, or any
+    // sample type KickSampleTraits describes (math is called unqualified, branches go through choose)
+    template <int ShapeType, typename T>
+    static T render(T phase, T dt)
+    {
+        using Traits = KickSampleTraits<T>;
+
+        if constexpr (ShapeType == sine)
+        {
+            using std::sin;
+            return sin(phase * T(juce::MathConstants<float>::twoPi));
+        }
+        else if constexpr (ShapeType == triangle)
+        {
+            // Slope +4 on [0, 0.5), -4 on [0.5, 1): slope changes of +-8 per cycle (8 dt per sample)
+            // at 0 and 0.5; polyBlamp is scaled for a change of 2 per sample
+            const T halfPhase = wrapHalfPhase(phase);
+            const T naive = Traits::choose(phase < T(0.5f), [&] { return T(4.0f) * phase - T(1.0f); },
+                                                            [&] { return T(3.0f) - T(4.0f) * phase; });
+            return naive + T(4.0f) * dt * (polyBlamp(phase, dt) - polyBlamp(halfPhase, dt));
+        }
+        else if constexpr (ShapeType == saw)
+        {
+            // Ramp -1..1 with a -2 step at the wrap (polyBlep is scaled for a step of 2)
+            return T(2.0f) * phase - T(1.0f) - polyBlep(phase, dt);
+        }
+        else
+        {
+            // +1 on [0, 0.5), -1 on [0.5, 1): +2 step at 0, -2 step at 0.5
+            const T halfPhase = wrapHalfPhase(phase);
+            const T naive = Traits::choose(phase < T(0.5f), [] { return T(1.0f); }, [] { return T(-1.0f); });
+            return naive + polyBlep(phase, dt) - polyBlep(halfPhase, dt);
+        }
+    }
+
+    // The unmodified shapes, for comparison (kick_bench --alias)
+    template <typename T>
+    static T renderNaive(int shape, T phase)
+    {
+        using std::sin;
+        switch (shape)
+        {
+            case sine:     return sin(phase * T(juce::MathConstants<float>::twoPi));
+            case triangle: return phase < T(0.5f) ? T(4.0f) * phase - T(1.0f) : T(3.0f) - T(4.0f) * phase;
+            case saw:      return T(2.0f) * phase - T(1.0f);
+            default:       return phase < T(0.5f) ? T(1.0f) : T(-1.0f);
+        }
+    }
+
+    // Residual of a -1 -> +1 step at phase 0, t cycles after (t < dt) or before (t > 1 - dt) it
+    template <typename T>
+    static T polyBlep(T t, T dt)
+    {
+        using Traits = KickSampleTraits<T>;
+        const auto after = [&] { const T x = t / dt; return x + x - x * x - T(1.0f); };
+        const auto before = [&] { const T x = (t - T(1.0f)) / dt; return x * x + x + x + T(1.0f); };
+        return Traits::choose(t < dt, after, [&] { return Traits::choose(t > T(1.0f) - dt, before, [] { return T(0.0f); }); });
+    }
+
+    // Residual of a slope change of +2 per sample at phase 0: the integral of polyBlep
+    template <typename T>
+    static T polyBlamp(T t, T dt)
+    {
+        using Traits = KickSampleTraits<T>;
+        const auto after = [&] { const T x = t / dt - T(1.0f); return T(-(1.0f / 3.0f)) * x * x * x; };
+        const auto before = [&] { const T x = (t - T(1.0f)) / dt + T(1.0f); return T(1.0f / 3.0f) * x * x * x; };
+        return Traits::choose(t < dt, after, [&] { return Traits::choose(t > T(1.0f) - dt, before, [] { return T(0.0f); }); });
+    }
+
+    // The phase half a cycle on, for the second corner or edge
+    template <typename T>
+    static T wrapHalfPhase(T phase)
+    {
+        const T halfPhase = phase + T(0.5f);
+        return KickSampleTraits<T>::choose(halfPhase >= T(1.0f), [&] { return halfPhase - T(1.0f); },
+                                                                 [&] { return halfPhase; });
+    }
+};
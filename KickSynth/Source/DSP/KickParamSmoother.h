@@ -0,0 +1,123 @@
+#pragma once
+
+#include "../JuceHeader.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * KickParamSmoother - Block-based parameter smoothing
+ *
+ * juce::SmoothedValue advances one step per getNextValue() call; this smoother instead writes
+ * the per-sample ramp for a whole block into a control buffer that the DSP kernels consume.
+ *
+ * Types:
+ * - Linear: straight ramp in the parameter's own units (levels, times)
+ * - Exponential: straight ramp in the log domain (frequencies, linear gains); targets must be > 0
+ *
+ * Once the target has been reached the smoother is settled: process() returns false without
+ * touching the destination, so callers can skip per-sample work entirely.
+ */
+class KickParamSmoother
+{
+public:
+    enum class Type
+    {
+        Linear,
+        Exponential
+    };
+
+    void setType(Type newType) { type = newType; }
+
+    // Sets the ramp length and snaps to the current target.
+    void reset(double sampleRate, double rampLengthSeconds)
+    {
+        rampLengthSamples = std::max(0, (int)std::floor(rampLengthSeconds * sampleRate));
+        setCurrentAndTargetValue(targetValue);
+    }
+
+    void setCurrentAndTargetValue(float newValue)
+    {
+        targetValue = newValue;
+        currentDomain = toDomain(newValue);
+        targetDomain = currentDomain;
+        step = 0.0f;
+        stepsRemaining = 0;
+    }
+
+    void setTargetValue(float newValue)
+    {
+        if (newValue == targetValue)
+            return;
+
+        if (rampLengthSamples <= 0)
+        {
+            setCurrentAndTargetValue(newValue);
+            return;
+        }
+
+        targetValue = newValue;
+        targetDomain = toDomain(newValue);
+        step = (targetDomain - currentDomain) / (float)rampLengthSamples;
+        stepsRemaining = rampLengthSamples;
+    }
+
+    bool isSmoothing() const { return stepsRemaining > 0; }
+    float getTargetValue() const { return targetValue; }
+    float getCurrentValue() const { return isSmoothing() ? fromDomain(currentDomain) : targetValue; }
+
+    /**
+     * Writes numSamples ramp values into dest and returns true, or returns false (dest untouched)
+     * when the smoother is settled and getCurrentValue() holds for the whole block.
+     */
+    bool process(float* dest, int numSamples)
+    {
+        if (stepsRemaining <= 0 || numSamples <= 0)
+            return false;
+
+        const int rampSamples = std::min(numSamples, stepsRemaining);
+        const float start = currentDomain;
+        const float increment = step;
+
+        for (int i = 0; i < rampSamples; ++i)
+            dest[i] = start + increment * (float)(i + 1);
+
+        if (type == Type::Exponential)
+            for (int i = 0; i < rampSamples; ++i)
+                dest[i] = std::exp(dest[i]);
+
+        stepsRemaining -= rampSamples;
+        if (stepsRemaining > 0)
+        {
+            currentDomain = start + increment * (float)rampSamples;
+        }
+        else
+        {
+            currentDomain = targetDomain;
+            dest[rampSamples - 1] = targetValue;
+        }
+
+        if (rampSamples < numSamples)
+            juce::FloatVectorOperations::fill(dest + rampSamples, targetValue, numSamples - rampSamples);
+
+        return true;
+    }
+
+private:
+    Type type = Type::Linear;
+    int rampLengthSamples = 0;
+    int stepsRemaining = 0;
+    float targetValue = 0.0f;
+    float currentDomain = 0.0f;
+    float targetDomain = 0.0f;
+    float step = 0.0f;
+
+    float toDomain(float value) const
+    {
+        return type == Type::Exponential ? std::log(std::max(value, 1.0e-9f)) : value;
+    }
+
+    float fromDomain(float value) const
+    {
+        return type == Type::Exponential ? std::exp(value) : value;
+    }
+};
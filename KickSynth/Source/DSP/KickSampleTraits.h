@@ -0,0 +1,36 @@
+#pragma once
+
+/**
+ * KickSampleTraits - What the templated voice code needs to know about its sample type
+ *
+ * KickVoice's synthesis and KickOscillator's shapes are written once for any sample type: float in
+ * the plugin, dual numbers in kick_fit's gradient model and lanes of floats in its batch renderer.
+ *
+ * - Wide: the type time and the amplitude envelope are evaluated in (double for float samples, so
+ *   the envelope keeps its precision late in the tail)
+ * - Mask: what comparing two samples yields
+ * - choose(mask, ifTrue, ifFalse): a branch on a sample. For scalars it is an ordinary branch that
+ *   calls one side only; a lane type, whose comparisons yield a mask of lanes, specialises the
+ *   traits to call both sides and pick per lane.
+ * - anyOf(mask): whether any lane of the mask is set
+ */
+template <typename Sample, typename WideSample = Sample>
+struct KickScalarSampleTraits
+{
+    using Wide = WideSample;
+    using Mask = bool;
+
+    static bool anyOf(bool mask) { return mask; }
+
+    template <typename IfTrue, typename IfFalse>
+    static auto choose(bool condition, IfTrue&& ifTrue, IfFalse&& ifFalse)
+    {
+        return condition ? ifTrue() : ifFalse();
+    }
+};
+
+template <typename Sample>
+struct KickSampleTraits : KickScalarSampleTraits<Sample> {};
+
+template <>
+struct KickSampleTraits<float> : KickScalarSampleTraits<float, double> {};
@@ -0,0 +1,197 @@
+#include "KickSignalChain.h"
+#include <algorithm>
+
+KickSignalChain::KickSignalChain()
+{
+    // Frequencies and gains ramp exponentially
+    smoothers[pitchStartControl].setType(KickParamSmoother::Type::Exponential);
+    smoothers[pitchEndControl].setType(KickParamSmoother::Type::Exponential);
+    smoothers[clickHPFHzControl].setType(KickParamSmoother::Type::Exponential);
+    smoothers[outputGainControl].setType(KickParamSmoother::Type::Exponential);
+    smoothers[outputHPFHzControl].setType(KickParamSmoother::Type::Exponential);
+    for (auto& smoother : smoothers)
+        smoother.reset(currentSampleRate, rampLengthSeconds);
+
+    controlBuffer.setSize(numSmoothedControls, controlBlockSize);
+}
+
+void KickSignalChain::prepare(double sampleRate)
+{
+    currentSampleRate = sampleRate;
+
+    voice.prepare(sampleRate);
+    distortion.prepare(sampleRate, controlBlockSize);
+    limiter.prepare(sampleRate, controlBlockSize);
+
+    for (auto& smoother : smoothers)
+        smoother.reset(sampleRate, rampLengthSeconds);
+
+    outputHPFDesignedHz = -1.0f;
+    reset();
+}
+
+void KickSignalChain::reset()
+{
+    outputHPF.reset();
+    distortion.reset();
+    limiter.reset();
+}
+
+void KickSignalChain::setParameters(const KickParams& params)
+{
+    smoothers[bodyLevelControl].setTargetValue(params.bodyLevel);
+    smoothers[clickLevelControl].setTargetValue(params.clickLevel);
+    smoothers[pitchStartControl].setTargetValue(params.pitchStartHz);
+    smoothers[pitchEndControl].setTargetValue(params.pitchEndHz);
+    smoothers[pitchTauControl].setTargetValue(params.pitchTauMs);
+    smoothers[attackMsControl].setTargetValue(params.attackMs);
+    smoothers[t12MsControl].setTargetValue(params.t12Ms);
+    smoothers[t24MsControl].setTargetValue(params.t24Ms);
+    smoothers[tailMsControl].setTargetValue(params.tailMsToMinus60Db);
+    smoothers[clickDecayMsControl].setTargetValue(params.clickDecayMs);
+    smoothers[clickHPFHzControl].setTargetValue(params.clickHPFHz);
+    smoothers[velocitySensitivityControl].setTargetValue(params.velocitySensitivity);
+    smoothers[driveControl].setTargetValue(params.drive);
+    smoothers[asymmetryControl].setTargetValue(params.asymmetry);
+    smoothers[outputGainControl].setTargetValue(juce::Decibels::decibelsToGain(params.outputGainDb));
+    smoothers[outputHPFHzControl].setTargetValue(params.outputHPFHz);
+
+    voice.setBodyOscillatorType(params.bodyOscType);
+    voice.setKeyTracking(params.keyTracking);
+    voice.setRetriggerMode(params.retriggerMode);
+    voice.setNoiseSeed((uint64_t)(uint32_t)params.noiseSeed);
+
+    distortion.setDistortionType(params.distortionType);
+    distortion.setAntialiasing(params.distortionAntialiasing);
+
+    limiter.setLimiterEnabled(params.limiterEnabled);
+    limiter.setMode(params.limiterMode);
+}
+
+void KickSignalChain::snapParameters()
+{
+    for (auto& smoother : smoothers)
+        smoother.setCurrentAndTargetValue(smoother.getTargetValue());
+
+    controlRamps.fill(nullptr);
+    numRampingVoiceControls = 0;
+    applySettledControls(1);
+}
+
+void KickSignalChain::beginChunk(int numSamples)
+{
+    jassert(numSamples <= controlBlockSize);
+
+    // Render ramps; settled controls skip the ramp and keep a single value for the chunk
+    numRampingVoiceControls = 0;
+    for (int control = 0; control < numSmoothedControls; ++control)
+    {
+        auto* ramp = controlBuffer.getWritePointer(control);
+        if (smoothers[(size_t)control].process(ramp, numSamples))
+        {
+            controlRamps[(size_t)control] = ramp;
+            if (control < numVoiceControls)
+                rampingVoiceControls[(size_t)numRampingVoiceControls++] = control;
+        }
+        else
+        {
+            controlRamps[(size_t)control] = nullptr;
+        }
+    }
+
+    applySettledControls(numSamples);
+}
+
+float KickSignalChain::controlValue(int control) const
+{
+    const auto* ramp = controlRamps[(size_t)control];
+    return ramp != nullptr ? ramp[0] : smoothers[(size_t)control].getCurrentValue();
+}
+
+void KickSignalChain::applySettledControls(int numSamples)
+{
+    // Voice (ramping controls are refreshed per sample in renderChunk)
+    for (int control = 0; control < numVoiceControls; ++control)
+        setVoiceControl(voice, control, controlValue(control));
+
+    distortion.setDrive(controlValue(driveControl));
+    distortion.setAsymmetry(controlValue(asymmetryControl));
+    limiter.setOutputGainLinear(controlValue(outputGainControl));
+
+    // Output HPF (coefficients only change while the cutoff moves)
+    const auto* hpfRamp = controlRamps[outputHPFHzControl];
+    const float hpfHz = hpfRamp != nullptr ? hpfRamp[numSamples - 1] : smoothers[outputHPFHzControl].getCurrentValue();
+    if (hpfHz != outputHPFDesignedHz)
+    {
+        using Coefficients = KickBiquad<float>::Coefficients;
+        outputHPF.setCoefficients(Coefficients::makeHighPass(currentSampleRate, Coefficients::limitCutoff(currentSampleRate, hpfHz)));
+        outputHPFDesignedHz = hpfHz;
+    }
+}
+
+void KickSignalChain::renderChunk(float* samples, int numSamples)
+{
+    // Voice: settled controls render the whole chunk through one specialised kernel
+    if (numRampingVoiceControls == 0)
+    {
+        voice.renderBlock(samples, numSamples);
+    }
+    else if (voice.isActive())
+    {
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            // Only controls that are still ramping need per-sample updates
+            for (int i = 0; i < numRampingVoiceControls; ++i)
+            {
+                const int control = rampingVoiceControls[(size_t)i];
+                setVoiceControl(voice, control, controlRamps[(size_t)control][sample]);
+            }
+
+            samples[sample] = voice.renderSample();
+        }
+    }
+    else
+    {
+        juce::FloatVectorOperations::clear(samples, numSamples);
+    }
+
+    renderEffects(samples, numSamples);
+}
+
+void KickSignalChain::renderEffects(float* samples, int numSamples)
+{
+    outputHPF.processBlock(samples, numSamples);
+    if (!distortionBypassed)
+        distortion.processBlock(samples, numSamples, controlRamps[driveControl], controlRamps[asymmetryControl]);
+    limiter.processBlock(samples, numSamples, controlRamps[outputGainControl]);
+}
+
+void KickSignalChain::process(float* samples, int numSamples)
+{
+    for (int startSample = 0; startSample < numSamples; startSample += controlBlockSize)
+    {
+        const int chunkSamples = std::min(controlBlockSize, numSamples - startSample);
+        beginChunk(chunkSamples);
+        renderChunk(samples + startSample, chunkSamples);
+    }
+}
+
+void KickSignalChain::setVoiceControl(KickVoice& voice, int control, float value)
+{
+    switch (control)
+    {
+        case bodyLevelControl:           voice.setBodyLevel(value); break;
+        case clickLevelControl:          voice.setClickLevel(value); break;
+        case pitchStartControl:          voice.setPitchStartHz(value); break;
+        case pitchEndControl:            voice.setPitchEndHz(value); break;
+        case pitchTauControl:            voice.setPitchTauMs(value); break;
+        case attackMsControl:            voice.setAttackMs(value); break;
+        case t12MsControl:               voice.setT12Ms(value); break;
+        case t24MsControl:               voice.setT24Ms(value); break;
+        case tailMsControl:              voice.setTailMsToMinus60Db(value); break;
+        case clickDecayMsControl:        voice.setClickDecayMs(value); break;
+        case clickHPFHzControl:          voice.setClickHPFHz(value); break;
+        case velocitySensitivityControl: voice.setVelocitySensitivity(value); break;
+        default: break;
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "../JuceHeader.h"
+#include "../KickParams.h"
+#include "KickVoice.h"
+#include "KickDistortion.h"
+#include "KickLimiter.h"
+#include "KickBiquad.h"
+#include "KickParamSmoother.h"
+#include <array>
+
+/**
+ * KickSignalChain - The complete mono kick path: voice -> output HPF -> distortion -> limiter
+ *
+ * Shared by the plugin and the offline KickRenderEngine so that both produce bit-identical output
+ * for the same KickParams snapshot. Continuous parameters are smoothed with per-sample ramps;
+ * blocks are processed in chunks of at most controlBlockSize samples, and the chunking is the same
+ * for both callers.
+ *
+ * Typical use per host block:
+ *   setParameters(snapshot);
+ *   for each chunk: beginChunk(n); [noteOn()/noteOff()]; renderChunk(buffer, n);
+ */
+class KickSignalChain
+{
+public:
+    static constexpr int controlBlockSize = 64;
+
+    KickSignalChain();
+
+    void prepare(double sampleRate);
+
+    // Clears the filter, distortion and limiter state (the voice is reset by noteOn)
+    void reset();
+
+    // New targets for the smoothed controls; discrete settings apply immediately
+    void setParameters(const KickParams& params);
+
+    // Jumps every smoothed control to its target
+    void snapParameters();
+
+    void noteOn(int noteNumber, float velocity) { voice.noteOn(noteNumber, velocity, currentSampleRate); }
+    void noteOff() { voice.noteOff(); }
+
+    // Renders the control ramps for the next chunk (numSamples <= controlBlockSize) and applies them
+    void beginChunk(int numSamples);
+
+    // Renders the voice into samples (overwriting them) and runs the effects on the chunk
+    void renderChunk(float* samples, int numSamples);
+    
+    // Runs the effects (output HPF, distortion, limiter) on a chunk rendered by the voice: the second
+    // half of renderChunk, for offline renderers that run the voice themselves
+    void renderEffects(float* samples, int numSamples);
+
+    // beginChunk + renderChunk over a whole buffer
+    void process(float* samples, int numSamples);
+
+    // Skips the distortion stage (offline layer renders only; the plugin never bypasses it)
+    void setDistortionBypassed(bool shouldBypass) { distortionBypassed = shouldBypass; }
+
+    int getLatencySamples() const { return limiter.getLatencySamples(); }
+    KickVoice& getVoice() { return voice; }
+
+private:
+    enum SmoothedControl
+    {
+        bodyLevelControl = 0,
+        clickLevelControl,
+        pitchStartControl,
+        pitchEndControl,
+        pitchTauControl,
+        attackMsControl,
+        t12MsControl,
+        t24MsControl,
+        tailMsControl,
+        clickDecayMsControl,
+        clickHPFHzControl,
+        velocitySensitivityControl,
+        numVoiceControls,
+        driveControl = numVoiceControls,
+        asymmetryControl,
+        outputGainControl, // linear gain
+        outputHPFHzControl,
+        numSmoothedControls
+    };
+
+    static constexpr double rampLengthSeconds = 0.05;
+
+    double currentSampleRate = 44100.0;
+
+    KickVoice voice;
+    KickBiquad<float> outputHPF;
+    KickDistortion distortion;
+    KickLimiter limiter;
+
+    // Parameter smoothing: per-sample ramps rendered into small control buffers
+    std::array<KickParamSmoother, numSmoothedControls> smoothers;
+    juce::AudioBuffer<float> controlBuffer;
+    std::array<const float*, numSmoothedControls> controlRamps{}; // nullptr = settled for this chunk
+    std::array<int, numVoiceControls> rampingVoiceControls{};
+    int numRampingVoiceControls = 0;
+    float outputHPFDesignedHz = -1.0f;
+    bool distortionBypassed = false;
+
+    float controlValue(int control) const;
+    void applySettledControls(int numSamples);
+    static void setVoiceControl(KickVoice& voice, int control, float value);
+};
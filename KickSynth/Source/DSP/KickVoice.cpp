@@ -2,217 +2,167 @@
 #include <algorithm>
 #include <cmath>
 
+namespace
+{
+    // Longest click burst: clickDecayMs tops out at 20 ms and the burst runs for five decay constants
+    constexpr double maxClickBurstMs = 100.0;
+}
+
 KickVoice::KickVoice()
 {
-    // Initialize click HPF
-    clickHPFCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighPass(44100.0, 2000.0f);
-    clickHPF.coefficients = clickHPFCoeffs;
+}
+
+int KickVoice::getBodyDividerForSampleRate(double sr)
+{
+    // Keep the body's internal rate at 22.05 kHz or above (pitch tops out at 500 Hz)
+    if (sr >= 176400.0)
+        return 8;
+    if (sr >= 88200.0)
+        return 4;
+    return 1;
+}
+
+void KickVoice::prepare(double sr)
+{
+    configureBodyRate(sr);
+    clickBurst.reserve((size_t)std::ceil(maxClickBurstMs * 0.001 * sr) + 1);
+    renderClickBurst();
 }
 
 void KickVoice::noteOn(int noteNum, float vel, double sr)
 {
     noteNumber = noteNum;
-    sampleRate = sr;
-    this->timeSinceNoteOn = 0.0;
+    if (bodyRateConfiguredFor != sr)
+        configureBodyRate(sr);
     this->active = true;
-    velocityScale = 1.0f + velocitySensitivity * (juce::jlimit(0.0f, 1.0f, vel) - 1.0f);
-    velocityScale = juce::jlimit(0.25f, 3.0f, velocityScale);
+    velocityScale = getVelocityScale(vel, velocitySensitivity);
     
-    // Reset oscillators
-    bodyPhase = 0.0f;
-    clickPhase = 0.0f;
-    clickNoiseState = juce::Random::getSystemRandom().nextFloat();
+    // Re-render the click burst only when its settings changed since the last hit
+    if (!clickBurstValid || clickBurstSampleRate != sr || clickBurstHPFHz != clickHPFHz
+        || clickBurstDecayMs != clickDecayMs || clickBurstSeed != noiseSeed)
+        renderClickBurst();
     
-    // Update click HPF sample rate
-    clickHPFCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, clickHPFHz);
-    clickHPF.coefficients = clickHPFCoeffs;
-    clickHPF.reset();
-    
-    // Initialize envelopes
-    currentPitchHz = pitchStartHz;
-    ampEnvValue = 0.0f;
-    pitchEnvValue = 1.0f;
+    synthesis.noteOn(parameters.pitchStartHz);
 }
 
 void KickVoice::noteOff()
 {
-    if (retriggerMode)
+    if (parameters.retriggerMode)
         active = false;
 }
 
+float KickVoice::getVelocityScale(float velocity, float sensitivity)
+{
+    const float scale = 1.0f + sensitivity * (juce::jlimit(0.0f, 1.0f, velocity) - 1.0f);
+    return juce::jlimit(0.25f, 3.0f, scale);
+}
+
 float KickVoice::renderSample()
 {
-    if (!active)
-        return 0.0f;
-    
-    // Update time
-    timeSinceNoteOn += 1.0 / sampleRate;
-    double timeMs = timeSinceNoteOn * 1000.0;
-    
-    // Update envelopes
-    updatePitchEnvelope();
-    updateAmpEnvelope();
-    
-    // Generate body
-    float bodySample = generateBodySample() * bodyLevel * ampEnvValue;
-    
-    // Generate click
-    float clickSample = generateClickSample() * clickLevel;
-    
-    // Combine
-    float output = (bodySample + clickSample) * velocityScale;
-    
-    // Check if voice should stop (tail reached -60dB or max duration)
-    if (ampEnvValue < 0.001f || timeMs > tailMsToMinus60Db * 2.0)
-    {
-        if (!retriggerMode)
-            active = false;
-    }
-    
+    float output = 0.0f;
+    renderBlock(&output, 1);
     return output;
 }
 
-float KickVoice::generateBodySample()
+void KickVoice::renderBlock(float* output, int numSamples)
 {
-    // Calculate phase increment based on current pitch
-    float freqHz = currentPitchHz;
-    
-    // Apply key tracking
-    if (keyTrackingSemitones != 0.0f)
-    {
-        float noteOffset = (noteNumber - 60.0f) + keyTrackingSemitones;
-        freqHz *= std::pow(2.0f, noteOffset / 12.0f);
-    }
-    
-    float phaseInc = freqHz / static_cast<float>(sampleRate);
-    
-    // Generate waveform
-    float sample = 0.0f;
-    if (bodyOscType == 0) // Sine
-    {
-        sample = std::sin(bodyPhase * juce::MathConstants<float>::twoPi);
-    }
-    else // Triangle
+    if (!active)
     {
-        float triPhase = std::fmod(bodyPhase, 1.0f);
-        if (triPhase < 0.5f)
-            sample = 4.0f * triPhase - 1.0f;
-        else
-            sample = 3.0f - 4.0f * triPhase;
+        juce::FloatVectorOperations::clear(output, numSamples);
+        return;
     }
     
-    // Update phase
-    bodyPhase += phaseInc;
-    if (bodyPhase >= 1.0f)
-        bodyPhase -= 1.0f;
-    
-    return sample;
+    const auto kernel = getRenderKernel<float>(bodyOscType,
+                                               parameters.keyTrackingSemitones != 0.0f,
+                                               parameters.attackMs != 0.0f,
+                                               synthesis.bodyDivider > 1);
+    active = (synthesis.*kernel)(getControls(), output, numSamples);
 }
 
-float KickVoice::generateClickSample()
+KickVoice::Controls<float> KickVoice::getControls() const
 {
-    // Generate noise burst with exponential decay
-    double timeMs = timeSinceNoteOn * 1000.0;
-    
-    if (timeMs > clickDecayMs * 5.0) // Click has decayed
-        return 0.0f;
-    
-    // Generate white noise using LCG
-    uint32_t state = static_cast<uint32_t>(clickNoiseState * 2147483647.0f);
-    state = state * 1103515245u + 12345u;
-    clickNoiseState = static_cast<float>(state & 0x7FFFFFFFu) / 2147483647.0f;
-    float noise = clickNoiseState * 2.0f - 1.0f;
-    
-    // Apply exponential decay
-    float decayEnv = exponentialDecay(static_cast<float>(timeMs), clickDecayMs);
-    
-    // Apply HPF for 2k-10k emphasis
-    float filtered = clickHPF.processSample(noise);
-    
-    return filtered * decayEnv;
+    auto controls = makeControls(parameters, noteNumber, velocityScale, synthesis.sampleRate);
+    controls.clickBurst = clickBurst.data();
+    controls.clickBurstLength = (int)clickBurst.size();
+    return controls;
 }
 
-void KickVoice::updatePitchEnvelope()
+int KickVoice::getClickBurstLength(double sr, float decayMs)
 {
-    // Exponential sweep: pitch(t) = pitchEnd + (pitchStart - pitchEnd) * exp(-t/tau)
-    float tauSamples = pitchTauMs / 1000.0f * static_cast<float>(sampleRate);
-    
-    if (tauSamples > 0.0f)
-    {
-        float expValue = std::exp(-static_cast<float>(timeSinceNoteOn) / (tauSamples / static_cast<float>(sampleRate)));
-        currentPitchHz = pitchEndHz + (pitchStartHz - pitchEndHz) * expValue;
-        pitchEnvValue = expValue;
-    }
-    else
-    {
-        currentPitchHz = pitchEndHz;
-        pitchEnvValue = 0.0f;
-    }
+    const int length = decayMs > 0.0f ? (int)std::floor(decayMs * 5.0 * sr / 1000.0) : 0;
+    return std::max(0, length);
 }
 
-void KickVoice::updateAmpEnvelope()
+void KickVoice::renderClickBurst()
 {
-    const double timeMs = timeSinceNoteOn * 1000.0;
-
-    // Attack phase (linear ramp to full scale).
-    if (timeMs < attackMsValue)
-    {
-        if (attackMsValue > 0.0f)
-            ampEnvValue = static_cast<float>(timeMs / attackMsValue);
-        else
-            ampEnvValue = 1.0f;
+    const double sr = synthesis.sampleRate;
+    clickBurstValid = true;
+    clickBurstSampleRate = sr;
+    clickBurstHPFHz = clickHPFHz;
+    clickBurstDecayMs = clickDecayMs;
+    clickBurstSeed = noiseSeed;
+    
+    const int length = getClickBurstLength(sr, clickDecayMs);
+    clickBurst.resize((size_t)length);
+    if (length <= 0)
         return;
-    }
+    
+    // Filtered noise, then the exponential decay as a running product
+    renderClickNoise(clickBurst.data(), length, sr, clickHPFHz, noiseSeed);
+    applyClickDecay(clickBurst.data(), length, sr, (double)clickDecayMs);
+}
 
-    // Decay phase: a piecewise log-linear envelope that hits the measurable timing points exactly.
-    //
-    // Definitions (as measured by the analyzer):
-    // - t12_ms: time from peak to -12 dB (A = 10^(-12/20))
-    // - t24_ms: time from peak to -24 dB (A = 10^(-24/20))
-    // - tail_ms_to_-60db: time from onset (note-on) to -60 dB (A = 10^(-60/20) = 0.001)
-    //
-    // The synth's decay starts after the attack ramp has reached its peak, so the -60 dB time from
-    // peak is (tail - attack). We clamp/repair invalid orderings to keep the envelope stable.
-    const double decayMs = timeMs - (double)attackMsValue;
-    const double t12 = std::max(0.0, (double)t12MsValue);
-    const double t24 = std::max(t12 + 1e-3, (double)t24MsValue);
-    const double t60FromPeak = std::max(t24 + 1e-3, (double)tailMsToMinus60Db - (double)attackMsValue);
-
-    constexpr double ln10 = 2.302585092994046;
-    constexpr double logA12 = -0.6 * ln10;  // ln(10^(-12/20))
-    constexpr double logA24 = -1.2 * ln10;  // ln(10^(-24/20))
-    constexpr double logA60 = -3.0 * ln10;  // ln(10^(-60/20)) = ln(0.001)
-
-    double logEnv = 0.0;
-    if (decayMs <= 0.0)
-    {
-        logEnv = 0.0;
-    }
-    else if (t12 > 0.0 && decayMs < t12)
-    {
-        const double u = decayMs / t12;
-        logEnv = u * logA12;
-    }
-    else if (decayMs < t24)
-    {
-        const double u = (decayMs - t12) / (t24 - t12);
-        logEnv = logA12 + u * (logA24 - logA12);
-    }
-    else
-    {
-        const double u = (decayMs - t24) / (t60FromPeak - t24);
-        logEnv = logA24 + u * (logA60 - logA24);
-    }
+void KickVoice::renderClickNoise(float* destination, int length, double sr, float hpfHz, uint64_t seed)
+{
+    // White noise
+    KickNoise noise(seed);
+    noise.fill(destination, length);
+    
+    // HPF for 2k-10k emphasis
+    using Coefficients = KickBiquad<float>::Coefficients;
+    KickBiquad<float> hpf(Coefficients::makeHighPass(sr, Coefficients::limitCutoff(sr, hpfHz)));
+    hpf.processBlock(destination, length);
+}
 
-    ampEnvValue = (float)std::exp(logEnv);
-    ampEnvValue = juce::jlimit(0.0f, 1.0f, ampEnvValue);
+void KickVoice::configureBodyRate(double sr)
+{
+    bodyRateConfiguredFor = sr;
+    const int divider = getBodyDividerForSampleRate(sr);
+    upsamplerKernels = getUpsamplerKernels(*sharedResources, divider);
+    synthesis.setBodyRate(sr, divider, upsamplerKernels.get());
 }
 
-float KickVoice::exponentialDecay(float timeMs, float tauMs)
+std::shared_ptr<const KickVoice::UpsamplerKernels> KickVoice::getUpsamplerKernels(SharedResources& resources, int divider)
 {
-    if (tauMs <= 0.0f)
-        return 0.0f;
-    
-    return std::exp(-timeMs / tauMs);
+    return resources.getTable<UpsamplerKernels>("KickVoice.upsampler." + juce::String(divider),
+                                                [divider]() { return makeUpsamplerKernels(divider); });
 }
 
+KickVoice::UpsamplerKernels KickVoice::makeUpsamplerKernels(int divider)
+{
+    // Windowed-sinc interpolator: phase p evaluates the band-limited body at m + p / divider from
+    // x[m-3..m+4]. Phase 0 reduces to x[m] exactly.
+    UpsamplerKernels kernels{};
+    for (int phase = 0; phase < divider; ++phase)
+    {
+        auto& kernel = kernels[(size_t)phase];
+        const double frac = (double)phase / (double)divider;
+        double sum = 0.0;
+        for (int i = 0; i < upsamplerTaps; ++i)
+        {
+            const double t = frac - (double)(i - (upsamplerLookahead - 1));
+            const double sinc = std::abs(t) < 1.0e-9 ? 1.0 : std::sin(juce::MathConstants<double>::pi * t)
+                                                           / (juce::MathConstants<double>::pi * t);
+            const double x = t / (0.5 * upsamplerTaps + 1.0);
+            const double window = std::cos(0.5 * juce::MathConstants<double>::pi * x);
+            kernel[(size_t)i] = (float)(sinc * window * window);
+            sum += kernel[(size_t)i];
+        }
+        
+        // Normalise DC gain
+        for (auto& h : kernel)
+            h = (float)(h / sum);
+    }
+    
+    return kernels;
+}
@@ -1,15 +1,38 @@
 #pragma once
 
 #include "../JuceHeader.h"
+#include "KickBiquad.h"
+#include "KickNoise.h"
+#include "KickOscillator.h"
+#include "KickSampleTraits.h"
+#include "SharedResources.h"
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
 
 /**
  * KickVoice - Synthesizes a kick drum with measurable parameters
  * 
  * Architecture:
- * - BODY oscillator (sine/triangle) with pitch envelope
- * - CLICK layer (noise burst with 2k-10k emphasis)
+ * - BODY oscillator (sine, or PolyBLAMP/PolyBLEP band-limited triangle/saw/square) with pitch envelope
+ * - CLICK layer (noise burst with 2k-10k emphasis), rendered once per
+ *   (sample rate, click HPF, click decay, noise seed) into a table that each hit plays back
  * - AMP envelope (attack + exponential decay)
+ * - Multi-rate: at 88.2 kHz and above the body (oscillator + envelopes) runs at 1/4 or 1/8 of the
+ *   host rate and is brought back up with an 8-tap-per-phase polyphase interpolator. The body is
+ *   rendered a few low-rate samples ahead so the interpolator adds no latency; the click stays at
+ *   the full rate.
  * - Distortion applied externally
+ *
+ * Rendering runs through kernels specialised at compile time on the oscillator type, key tracking
+ * on/off, attack on/off and single/multi-rate body. renderBlock() picks the kernel once per block, so
+ * the per-sample loop carries none of those branches; renderSample() is a one-sample block.
+ *
+ * The kernels belong to Synthesis, which holds the per-note state and is written for any sample type
+ * KickSampleTraits describes. The voice runs it on float; kick_fit's gradient model runs the same
+ * kernels on dual numbers and its batch renderer on lanes of floats.
  */
 class KickVoice
 {
@@ -17,38 +40,47 @@ public:
     KickVoice();
     ~KickVoice() = default;
 
+    // Allocates the click burst table and picks the body rate for this sample rate; call before rendering
+    void prepare(double sampleRate);
+    
+    // Body decimation factor used at a given host rate (1 = full rate)
+    static int getBodyDividerForSampleRate(double sampleRate);
+
     // Voice management
     void noteOn(int noteNumber, float velocity, double sampleRate);
     void noteOff();
     bool isActive() const { return active; }
     
     // Parameter setters (all values normalized 0-1 except where noted)
-    void setBodyLevel(float level) { bodyLevel = level; }
-    void setClickLevel(float level) { clickLevel = level; }
+    void setBodyLevel(float level) { parameters.bodyLevel = level; }
+    void setClickLevel(float level) { parameters.clickLevel = level; }
     
     // Pitch envelope parameters (Hz)
-    void setPitchStartHz(float hz) { pitchStartHz = hz; }
-    void setPitchEndHz(float hz) { pitchEndHz = hz; }
-    void setPitchTauMs(float tauMs) { pitchTauMs = tauMs; }
+    void setPitchStartHz(float hz) { parameters.pitchStartHz = hz; }
+    void setPitchEndHz(float hz) { parameters.pitchEndHz = hz; }
+    void setPitchTauMs(float tauMs) { parameters.pitchTauMs = tauMs; }
     
     // Amplitude envelope parameters (ms)
-    void setAttackMs(float attackMs) { attackMsValue = attackMs; }
-    void setT12Ms(float t12Ms) { t12MsValue = t12Ms; }
-    void setT24Ms(float t24Ms) { t24MsValue = t24Ms; }
-    void setTailMsToMinus60Db(float tailMs) { tailMsToMinus60Db = tailMs; }
+    void setAttackMs(float attackMs) { parameters.attackMs = attackMs; }
+    void setT12Ms(float t12Ms) { parameters.t12Ms = t12Ms; }
+    void setT24Ms(float t24Ms) { parameters.t24Ms = t24Ms; }
+    void setTailMsToMinus60Db(float tailMs) { parameters.tailMsToMinus60Db = tailMs; }
     
     // Click layer parameters
     void setClickDecayMs(float decayMs) { clickDecayMs = decayMs; }
     void setClickHPFHz(float hpfHz) { clickHPFHz = hpfHz; }
     
+    // Seed of the click noise; the same seed always renders the same burst
+    void setNoiseSeed(uint64_t seed) { noiseSeed = seed; }
+    
     // Body oscillator type
-    void setBodyOscillatorType(int type) { bodyOscType = type; } // 0=sine, 1=triangle
+    void setBodyOscillatorType(int type) { bodyOscType = juce::jlimit(0, KickOscillator::numShapes - 1, type); } // 0=sine, 1=triangle, 2=saw, 3=square
     
     // Key tracking
-    void setKeyTracking(float semitones) { keyTrackingSemitones = semitones; }
+    void setKeyTracking(float semitones) { parameters.keyTrackingSemitones = semitones; }
     
     // Retrigger mode: true=gate (note-off kills voice), false=one-shot
-    void setRetriggerMode(bool enabled) { retriggerMode = enabled; }
+    void setRetriggerMode(bool enabled) { parameters.retriggerMode = enabled; }
 
     // Velocity sensitivity: 0=no change, 1=full velocity response
     void setVelocitySensitivity(float amount) { velocitySensitivity = amount; }
@@ -56,67 +88,528 @@ public:
     // Render one sample
     float renderSample();
     
+    // Render a block (overwrites output); parameters are treated as constant for the block
+    void renderBlock(float* output, int numSamples);
+    
     // Get current pitch for analysis
-    float getCurrentPitchHz() const { return currentPitchHz; }
+    float getCurrentPitchHz() const { return synthesis.currentPitchHz; }
     
     // Get envelope value for visualization
-    float getAmpEnvelopeValue() const { return ampEnvValue; }
-    float getPitchEnvelopeValue() const { return pitchEnvValue; }
+    float getAmpEnvelopeValue() const { return synthesis.ampEnvValue; }
+    float getPitchEnvelopeValue() const { return synthesis.pitchEnvValue; }
+    
+    // The envelope shapes as functions of time, for any sample type KickSampleTraits describes: the
+    // voice runs them in float/double (math is called unqualified so the type's own overloads are
+    // found, branches go through choose)
+    
+    // Pitch sweep weight exp(-t/tau): pitch = end + (start - end) * weight
+    template <typename T>
+    static T pitchSweepWeight(T timeSeconds, T tauSeconds)
+    {
+        using std::exp;
+        return exp(-timeSeconds / tauSeconds);
+    }
+    
+    // Decay breakpoints in ms from the peak. The -60 dB time from the peak is (tail - attack);
+    // invalid orderings are clamped/repaired to keep the envelope stable.
+    template <typename T>
+    struct DecayShape
+    {
+        T t12Ms;
+        T t24Ms;
+        T t60FromPeakMs;
+    };
+    
+    template <typename T>
+    static DecayShape<T> makeDecayShape(T t12Ms, T t24Ms, T tailMs, T attackMs)
+    {
+        auto maxOf = [](T a, T b) { return KickSampleTraits<T>::choose(a < b, [&] { return b; }, [&] { return a; }); };
+        DecayShape<T> shape { maxOf(T(0.0), t12Ms), T(0.0), T(0.0) };
+        shape.t24Ms = maxOf(shape.t12Ms + 1e-3, t24Ms);
+        shape.t60FromPeakMs = maxOf(shape.t24Ms + 1e-3, tailMs - attackMs);
+        return shape;
+    }
+    
+    // Natural log of the decay envelope decayMs after the peak: piecewise linear in the log domain
+    // through 0 dB at the peak, -12 dB at t12, -24 dB at t24 and -60 dB at t60
+    template <typename T>
+    static T decayLogEnvelope(T decayMs, const DecayShape<T>& shape)
+    {
+        using Traits = KickSampleTraits<T>;
+        constexpr double ln10 = 2.302585092994046;
+        constexpr double logA12 = -0.6 * ln10;  // ln(10^(-12/20))
+        constexpr double logA24 = -1.2 * ln10;  // ln(10^(-24/20))
+        constexpr double logA60 = -3.0 * ln10;  // ln(10^(-60/20)) = ln(0.001)
+        
+        const T& t12 = shape.t12Ms;
+        const T& t24 = shape.t24Ms;
+        const T& t60FromPeak = shape.t60FromPeakMs;
+        
+        const auto fromT24 = [&]
+        {
+            const T u = (decayMs - t24) / (t60FromPeak - t24);
+            return T(logA24 + u * (logA60 - logA24));
+        };
+        const auto fromT12 = [&]
+        {
+            return Traits::choose(decayMs < t24, [&]
+            {
+                const T u = (decayMs - t12) / (t24 - t12);
+                return T(logA12 + u * (logA24 - logA12));
+            }, fromT24);
+        };
+        const auto fromPeak = [&]
+        {
+            return Traits::choose(t12 > T(0.0) && decayMs < t12, [&]
+            {
+                const T u = decayMs / t12;
+                return T(u * logA12);
+            }, fromT12);
+        };
+        return Traits::choose(decayMs <= T(0.0), [] { return T(0.0); }, fromPeak);
+    }
+    
+    // The click noise before its decay envelope: seeded white noise through the click HPF. The voice
+    // plays it back multiplied by exp(-t / clickDecay) for five decay constants.
+    static void renderClickNoise(float* destination, int length, double sampleRate, float hpfHz, uint64_t seed);
+    
+    // Samples in the click burst: five decay constants (sample i sits at t = (i + 1) / sampleRate)
+    static int getClickBurstLength(double sampleRate, float clickDecayMs);
+    
+    // Multiplies the click noise by its decay envelope, as a running product in the wide type
+    template <typename Sample>
+    static void applyClickDecay(Sample* burst, int length, double sampleRate,
+                                const typename KickSampleTraits<Sample>::Wide& decayMs)
+    {
+        using std::exp;
+        using Wide = typename KickSampleTraits<Sample>::Wide;
+        
+        const Wide decayPerSample = exp(-1000.0 / (sampleRate * decayMs));
+        Wide decayEnv = decayPerSample;
+        for (int i = 0; i < length; ++i)
+        {
+            burst[i] *= Sample(decayEnv);
+            decayEnv *= decayPerSample;
+        }
+    }
+    
+    // Output scale for a note-on velocity
+    static float getVelocityScale(float velocity, float sensitivity);
+    
+    // Multi-rate body: low-rate samples x[m-3..m+4] around the current output and the polyphase
+    // interpolation kernels (one per output phase, shared by every voice with the same divider)
+    static constexpr int maxBodyDivider = 8;
+    static constexpr int upsamplerTaps = 8;
+    static constexpr int upsamplerLookahead = upsamplerTaps / 2;
+    using UpsamplerKernels = std::array<std::array<float, upsamplerTaps>, maxBodyDivider>;
+    static std::shared_ptr<const UpsamplerKernels> getUpsamplerKernels(SharedResources& resources, int divider);
+    
+    // The voice's continuous parameters in a sample type (the voice keeps them in float)
+    template <typename Sample>
+    struct Parameters
+    {
+        Sample bodyLevel = Sample(1.0f);
+        Sample clickLevel = Sample(0.5f);
+        Sample pitchStartHz = Sample(200.0f);
+        Sample pitchEndHz = Sample(50.0f);
+        Sample pitchTauMs = Sample(20.0f);
+        Sample attackMs = Sample(0.0f);
+        Sample t12Ms = Sample(5.0f);  // Time to -12dB
+        Sample t24Ms = Sample(20.0f); // Time to -24dB
+        Sample tailMsToMinus60Db = Sample(70.0f);
+        float keyTrackingSemitones = 0.0f;
+        bool retriggerMode = false; // true=gate (note-off kills voice), false=one-shot
+    };
+    
+    // What the per-sample loop reads, derived from the parameters once per block instead of once
+    // per sample
+    template <typename Sample>
+    struct Controls
+    {
+        using Wide = typename KickSampleTraits<Sample>::Wide;
+        using Mask = typename KickSampleTraits<Sample>::Mask;
+        
+        Sample pitchStartHz {};
+        Sample pitchEndHz {};
+        Mask hasPitchTau {};
+        Sample pitchTauSeconds {};
+        Sample keyTrackingRatio = Sample(1.0f);
+        Wide attackMs {};
+        DecayShape<Wide> decay {};
+        Wide tailLimitMs {}; // a one-shot voice stops at twice the -60 dB time at the latest
+        Sample bodyLevel {};
+        Sample clickLevel {};
+        Sample velocityScale = Sample(1.0f);
+        Mask oneShot {};
+        
+        // Click burst (owned by the caller)
+        const Sample* clickBurst = nullptr;
+        int clickBurstLength = 0;
+    };
+    
+    // Controls for a note, without the click burst
+    template <typename Sample>
+    static Controls<Sample> makeControls(const Parameters<Sample>& parameters, int noteNumber,
+                                         const Sample& velocityScale, double sampleRate);
+    
+    // The per-note state and the render kernels
+    template <typename Sample>
+    struct Synthesis
+    {
+        using Traits = KickSampleTraits<Sample>;
+        using Wide = typename Traits::Wide;
+        using Mask = typename Traits::Mask;
+        
+        // Host rate, body decimation factor and the matching interpolation kernels
+        void setBodyRate(double newSampleRate, int divider, const UpsamplerKernels* kernels);
+        
+        // Back to the note-on: time, phase, envelopes, click playback and body history
+        void noteOn(const Sample& pitchStartHz);
+        
+        // Renders numSamples into output (overwriting it). Returns false, with the rest of the output
+        // cleared, once the voice has stopped (every lane of it, for a lane type).
+        template <int OscType, bool KeyTracked, bool HasAttack, bool MultiRate>
+        bool render(const Controls<Sample>& controls, Sample* output, int numSamples);
+        
+        double sampleRate = 44100.0;
+        int bodyDivider = 1;
+        float bodySampleRate = 44100.0f;
+        const UpsamplerKernels* upsamplerKernels = nullptr;
+        
+        double timeSinceNoteOn = 0.0;
+        Sample bodyPhase {};
+        Sample currentPitchHz = Sample(200.0f);
+        Sample pitchEnvValue = Sample(1.0f);
+        Sample ampEnvValue {};
+        Mask running {}; // lanes still sounding; a lane renderer may clear the ones it no longer needs
+        int clickBurstPos = 0;
+        
+        std::array<Sample, upsamplerTaps> bodyHistory {};
+        int bodyOutputPhase = 0;
+        int64_t bodySampleIndex = 0;
+        bool bodyHistoryPrimed = false;
+        
+    private:
+        template <int OscType, bool KeyTracked>
+        Sample generateBodySample(const Controls<Sample>& controls);
+        template <int OscType, bool KeyTracked, bool HasAttack>
+        Sample renderLowRateBodySample(const Controls<Sample>& controls);
+        template <int OscType, bool KeyTracked, bool HasAttack>
+        Sample upsampleBodySample(const Controls<Sample>& controls);
+        Sample generateClickSample(const Controls<Sample>& controls);
+        void updatePitchEnvelope(double timeSeconds, const Controls<Sample>& controls);
+        template <bool HasAttack>
+        void updateAmpEnvelope(double timeSeconds, const Controls<Sample>& controls);
+        static Sample limitToUnit(const Sample& value);
+    };
+    
+    // Render kernel for one combination of the discrete settings
+    template <typename Sample>
+    using RenderKernel = bool (Synthesis<Sample>::*)(const Controls<Sample>&, Sample*, int);
+    
+    template <typename Sample>
+    static RenderKernel<Sample> getRenderKernel(int oscType, bool keyTracked, bool hasAttack, bool multiRate)
+    {
+        static constexpr auto kernels = makeRenderKernels<Sample>(std::make_index_sequence<numRenderKernels>());
+        
+        const int index = juce::jlimit(0, KickOscillator::numShapes - 1, oscType) * 8
+                        + (keyTracked ? 4 : 0)
+                        + (hasAttack ? 2 : 0)
+                        + (multiRate ? 1 : 0);
+        return kernels[(size_t)index];
+    }
+    
+    // What the next block renders with, click burst included, and the shape it renders: for
+    // renderers that run several voices as lanes of one Synthesis (KickBatchRenderEngine)
+    Controls<float> getControls() const;
+    int getBodyOscillatorType() const { return bodyOscType; }
 
 private:
     // State
     bool active = false;
-    double sampleRate = 44100.0;
-    double timeSinceNoteOn = 0.0;
     int noteNumber = 60; // C4
+    int bodyOscType = 0; // 0=sine, 1=triangle, 2=saw, 3=square
     
-    // Body oscillator
-    float bodyPhase = 0.0f;
-    int bodyOscType = 0; // 0=sine, 1=triangle
+    // Body rate: the synthesis runs at the host rate divided by its body divider
+    double bodyRateConfiguredFor = 0.0;
+    juce::SharedResourcePointer<SharedResources> sharedResources;
+    std::shared_ptr<const UpsamplerKernels> upsamplerKernels;
     
-    // Click layer
-    float clickPhase = 0.0f;
-    float clickNoiseState = 0.0f;
-    juce::dsp::IIR::Filter<float> clickHPF;
-    juce::dsp::IIR::Coefficients<float>::Ptr clickHPFCoeffs;
-    
-    // Pitch envelope (exponential sweep)
-    float pitchStartHz = 200.0f;
-    float pitchEndHz = 50.0f;
-    float pitchTauMs = 20.0f;
-    float currentPitchHz = 200.0f;
-    float pitchEnvValue = 1.0f;
-    
-    // Amplitude envelope (attack + exponential decay)
-    float attackMsValue = 0.0f;
-    float t12MsValue = 5.0f;  // Time to -12dB
-    float t24MsValue = 20.0f; // Time to -24dB
-    float tailMsToMinus60Db = 70.0f;
-    float ampEnvValue = 0.0f;
+    Synthesis<float> synthesis;
+    
+    // Click layer: burst table (filtered, enveloped noise)
+    std::vector<float> clickBurst;
+    uint64_t noiseSeed = 1;
+    
+    // Settings the burst table was rendered with
+    bool clickBurstValid = false;
+    double clickBurstSampleRate = 0.0;
+    float clickBurstHPFHz = 0.0f;
+    float clickBurstDecayMs = 0.0f;
+    uint64_t clickBurstSeed = 0;
+    
+    // Pitch, amplitude envelope, level, key tracking and retrigger parameters
+    Parameters<float> parameters;
     
     // Click layer
     float clickDecayMs = 3.0f;
     float clickHPFHz = 2000.0f;
     
-    // Levels
-    float bodyLevel = 1.0f;
-    float clickLevel = 0.5f;
-    
-    // Key tracking
-    float keyTrackingSemitones = 0.0f;
-    
-    // Retrigger mode: true=gate (note-off kills voice), false=one-shot
-    bool retriggerMode = false;
-
     // Velocity control
     float velocitySensitivity = 1.0f;
     float velocityScale = 1.0f;
     
+    static constexpr int numRenderKernels = KickOscillator::numShapes * 8;
+    
+    template <typename Sample, size_t... Index>
+    static constexpr std::array<RenderKernel<Sample>, sizeof...(Index)> makeRenderKernels(std::index_sequence<Index...>)
+    {
+        // Index bits: oscillator type (8), key tracking (4), attack (2), multi-rate (1)
+        return {{ &Synthesis<Sample>::template render<(int)(Index >> 3), ((Index >> 2) & 1) != 0,
+                                                      ((Index >> 1) & 1) != 0, (Index & 1) != 0>... }};
+    }
+    
     // Helper functions
-    float generateBodySample();
-    float generateClickSample();
-    void updatePitchEnvelope();
-    void updateAmpEnvelope();
-    float exponentialDecay(float timeMs, float tauMs);
+    void configureBodyRate(double sampleRate);
+    static UpsamplerKernels makeUpsamplerKernels(int divider);
+    void renderClickBurst();
 };
 
+template <typename Sample>
+KickVoice::Controls<Sample> KickVoice::makeControls(const Parameters<Sample>& parameters, int noteNumber,
+                                                    const Sample& velocityScale, double sampleRate)
+{
+    using Wide = typename KickSampleTraits<Sample>::Wide;
+    
+    Controls<Sample> controls;
+    controls.pitchStartHz = parameters.pitchStartHz;
+    controls.pitchEndHz = parameters.pitchEndHz;
+    
+    if (parameters.keyTrackingSemitones != 0.0f)
+    {
+        const float noteOffset = (noteNumber - 60.0f) + parameters.keyTrackingSemitones;
+        controls.keyTrackingRatio = Sample(std::pow(2.0f, noteOffset / 12.0f));
+    }
+    
+    const Sample tauSamples = parameters.pitchTauMs / Sample(1000.0f) * Sample(static_cast<float>(sampleRate));
+    controls.hasPitchTau = tauSamples > Sample(0.0f);
+    controls.pitchTauSeconds = tauSamples / Sample(static_cast<float>(sampleRate));
+    
+    // The synth's decay starts after the attack ramp has reached its peak
+    controls.attackMs = Wide(parameters.attackMs);
+    controls.decay = makeDecayShape<Wide>(Wide(parameters.t12Ms), Wide(parameters.t24Ms),
+                                          Wide(parameters.tailMsToMinus60Db), Wide(parameters.attackMs));
+    controls.tailLimitMs = Wide(parameters.tailMsToMinus60Db) * 2.0;
+    
+    controls.bodyLevel = parameters.bodyLevel;
+    controls.clickLevel = parameters.clickLevel;
+    controls.velocityScale = velocityScale;
+    controls.oneShot = !parameters.retriggerMode;
+    return controls;
+}
+
+template <typename Sample>
+void KickVoice::Synthesis<Sample>::setBodyRate(double newSampleRate, int divider, const UpsamplerKernels* kernels)
+{
+    sampleRate = newSampleRate;
+    bodyDivider = divider;
+    bodySampleRate = static_cast<float>(newSampleRate / divider);
+    upsamplerKernels = kernels;
+}
+
+template <typename Sample>
+void KickVoice::Synthesis<Sample>::noteOn(const Sample& pitchStartHz)
+{
+    timeSinceNoteOn = 0.0;
+    running = Mask(true);
+    
+    // Reset oscillators and click playback
+    bodyPhase = Sample(0.0f);
+    clickBurstPos = 0;
+    
+    // Initialize envelopes
+    currentPitchHz = pitchStartHz;
+    ampEnvValue = Sample(0.0f);
+    pitchEnvValue = Sample(1.0f);
+    
+    // Multi-rate body: silence before the note; the first rendered block primes the lookahead so
+    // the first output sample already sees x[0..4]
+    bodyHistory.fill(Sample(0.0f));
+    bodySampleIndex = 0;
+    bodyOutputPhase = 0;
+    bodyHistoryPrimed = false;
+}
+
+template <typename Sample>
+template <int OscType, bool KeyTracked, bool HasAttack, bool MultiRate>
+bool KickVoice::Synthesis<Sample>::render(const Controls<Sample>& controls, Sample* output, int numSamples)
+{
+    if constexpr (MultiRate)
+    {
+        if (!bodyHistoryPrimed)
+        {
+            for (int i = upsamplerLookahead - 1; i < upsamplerTaps; ++i)
+                bodyHistory[(size_t)i] = renderLowRateBodySample<OscType, KeyTracked, HasAttack>(controls);
+            bodyHistoryPrimed = true;
+        }
+    }
+    
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        // Update time
+        timeSinceNoteOn += 1.0 / sampleRate;
+        const double timeMs = timeSinceNoteOn * 1000.0;
+        
+        // Generate body
+        Sample bodySample;
+        if constexpr (MultiRate)
+        {
+            bodySample = upsampleBodySample<OscType, KeyTracked, HasAttack>(controls);
+        }
+        else
+        {
+            updatePitchEnvelope(timeSinceNoteOn, controls);
+            updateAmpEnvelope<HasAttack>(timeSinceNoteOn, controls);
+            bodySample = generateBodySample<OscType, KeyTracked>(controls) * controls.bodyLevel * ampEnvValue;
+        }
+        
+        // Generate click
+        const Sample clickSample = generateClickSample(controls) * controls.clickLevel;
+        
+        // Combine (stopped lanes stay silent)
+        output[sample] = Traits::choose(running, [&] { return (bodySample + clickSample) * controls.velocityScale; },
+                                                 [] { return Sample(0.0f); });
+        
+        // Check if voice should stop (tail reached -60dB or max duration)
+        const Mask stopping = (ampEnvValue < Sample(0.001f) || Wide(timeMs) > controls.tailLimitMs) && controls.oneShot;
+        if (Traits::anyOf(stopping))
+        {
+            running = running && !stopping;
+            if (!Traits::anyOf(running))
+            {
+                std::fill(output + sample + 1, output + numSamples, Sample(0.0f));
+                return false;
+            }
+        }
+    }
+    
+    return true;
+}
+
+template <typename Sample>
+template <int OscType, bool KeyTracked>
+Sample KickVoice::Synthesis<Sample>::generateBodySample(const Controls<Sample>& controls)
+{
+    // Calculate phase increment based on current pitch
+    Sample freqHz = currentPitchHz;
+    
+    // Apply key tracking
+    if constexpr (KeyTracked)
+        freqHz *= controls.keyTrackingRatio;
+    
+    const Sample phaseInc = freqHz / Sample(bodySampleRate);
+    
+    // Generate waveform (band-limited for the shapes with corners or edges); dt = jmin(phaseInc, 0.5)
+    const Sample dt = Traits::choose(Sample(0.5f) < phaseInc, [] { return Sample(0.5f); }, [&] { return phaseInc; });
+    const Sample sample = KickOscillator::render<OscType>(bodyPhase, dt);
+    
+    // Update phase
+    bodyPhase += phaseInc;
+    bodyPhase = Traits::choose(bodyPhase >= Sample(1.0f), [&] { return bodyPhase - Sample(1.0f); },
+                                                          [&] { return bodyPhase; });
+    
+    return sample;
+}
+
+template <typename Sample>
+Sample KickVoice::Synthesis<Sample>::generateClickSample(const Controls<Sample>& controls)
+{
+    // Play back the precomputed burst; silent once it has decayed
+    if (clickBurstPos >= controls.clickBurstLength)
+        return Sample(0.0f);
+    
+    return controls.clickBurst[clickBurstPos++];
+}
+
+template <typename Sample>
+template <int OscType, bool KeyTracked, bool HasAttack>
+Sample KickVoice::Synthesis<Sample>::renderLowRateBodySample(const Controls<Sample>& controls)
+{
+    // Low-rate sample j lines up with full-rate output j * divider, which sits at t = (j * divider + 1) / sr
+    const double timeSeconds = (double)(bodySampleIndex * bodyDivider + 1) / sampleRate;
+    ++bodySampleIndex;
+    
+    updatePitchEnvelope(timeSeconds, controls);
+    updateAmpEnvelope<HasAttack>(timeSeconds, controls);
+    return generateBodySample<OscType, KeyTracked>(controls) * controls.bodyLevel * ampEnvValue;
+}
+
+template <typename Sample>
+template <int OscType, bool KeyTracked, bool HasAttack>
+Sample KickVoice::Synthesis<Sample>::upsampleBodySample(const Controls<Sample>& controls)
+{
+    // Advance to the next low-rate sample once every phase has been output
+    if (bodyOutputPhase == bodyDivider)
+    {
+        std::copy(bodyHistory.begin() + 1, bodyHistory.end(), bodyHistory.begin());
+        bodyHistory[upsamplerTaps - 1] = renderLowRateBodySample<OscType, KeyTracked, HasAttack>(controls);
+        bodyOutputPhase = 0;
+    }
+    
+    const auto& kernel = (*upsamplerKernels)[(size_t)bodyOutputPhase++];
+    Sample sum(0.0f);
+    for (int i = 0; i < upsamplerTaps; ++i)
+        sum += Sample(kernel[(size_t)i]) * bodyHistory[(size_t)i];
+    return sum;
+}
+
+template <typename Sample>
+void KickVoice::Synthesis<Sample>::updatePitchEnvelope(double timeSeconds, const Controls<Sample>& controls)
+{
+    // Exponential sweep: pitch(t) = pitchEnd + (pitchStart - pitchEnd) * exp(-t/tau)
+    const Sample expValue = Traits::choose(controls.hasPitchTau,
+                                           [&] { return pitchSweepWeight(Sample(timeSeconds), controls.pitchTauSeconds); },
+                                           [] { return Sample(0.0f); });
+    currentPitchHz = Traits::choose(controls.hasPitchTau,
+                                    [&] { return controls.pitchEndHz + (controls.pitchStartHz - controls.pitchEndHz) * expValue; },
+                                    [&] { return controls.pitchEndHz; });
+    pitchEnvValue = expValue;
+}
+
+template <typename Sample>
+template <bool HasAttack>
+void KickVoice::Synthesis<Sample>::updateAmpEnvelope(double timeSeconds, const Controls<Sample>& controls)
+{
+    const Wide timeMs = Wide(timeSeconds * 1000.0);
+    
+    // Decay phase: a piecewise log-linear envelope that hits the measurable timing points exactly.
+    //
+    // Definitions (as measured by the analyzer):
+    // - t12_ms: time from peak to -12 dB (A = 10^(-12/20))
+    // - t24_ms: time from peak to -24 dB (A = 10^(-24/20))
+    // - tail_ms_to_-60db: time from onset (note-on) to -60 dB (A = 10^(-60/20) = 0.001)
+    //
+    // The breakpoints (clamped into order) come from makeControls().
+    const auto decayValue = [&](const Wide& decayMs)
+    {
+        using std::exp;
+        return limitToUnit(Sample(exp(decayLogEnvelope(decayMs, controls.decay))));
+    };
+    
+    // Attack phase (linear ramp to full scale). Without an attack the decay starts at note-on.
+    if constexpr (HasAttack)
+        ampEnvValue = Traits::choose(timeMs < controls.attackMs, [&] { return Sample(timeMs / controls.attackMs); },
+                                                                 [&] { return decayValue(timeMs - controls.attackMs); });
+    else
+        ampEnvValue = decayValue(timeMs);
+}
+
+template <typename Sample>
+Sample KickVoice::Synthesis<Sample>::limitToUnit(const Sample& value)
+{
+    // juce::jlimit(0, 1, value)
+    return Traits::choose(value < Sample(0.0f), [] { return Sample(0.0f); }, [&]
+    {
+        return Traits::choose(Sample(1.0f) < value, [] { return Sample(1.0f); }, [&] { return value; });
+    });
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+
+/**
+ * KickParameterSchema - Single source of truth for the KickSynth parameters
+ *
+ * Every parameter is declared once in KICK_PARAMETERS. The list generates:
+ * - the KickParams members and their typed get/set by index (KickParams.h)
+ * - the APVTS layout and the processor's cached parameter atomics (PluginProcessor.cpp)
+ * - JSON load/save, including the editor's params buttons (KickParams.cpp)
+ * - clamping and the kick_fit coordinate-descent specs (fitStep > 0)
+ *
+ * Columns:
+ *   kind       Float (float), Choice (int index) or Bool (bool)
+ *   member     KickParams member name
+ *   id         APVTS parameter ID (never rename: hosts store automation against it)
+ *   name       display name
+ *   jsonKey    key in params JSON files (the ID is also accepted when loading)
+ *   min/max    range; also the clamp range for fitting. Choices run 0..numChoices-1
+ *   default    default value
+ *   choices    '|'-separated labels for Choice parameters
+ *   fitStep    initial kick_fit coordinate-descent step (0 = not fitted)
+ *   fitMinStep smallest step before refinement stops
+ */
+#define KICK_PARAMETERS(X) \
+    X(Float,  bodyLevel,              "bodyLevel",              "Body Level",              "bodyLevel",              0.0f,   1.0f,     1.0f,    "",                                      0.05f,  0.005f) \
+    X(Float,  clickLevel,             "clickLevel",             "Click Level",             "clickLevel",             0.0f,   1.0f,     0.5f,    "",                                      0.05f,  0.005f) \
+    X(Float,  pitchStartHz,           "pitchStartHz",           "Pitch Start Hz",          "pitchStartHz",           20.0f,  500.0f,   200.0f,  "",                                      20.0f,  1.0f)   \
+    X(Float,  pitchEndHz,             "pitchEndHz",             "Pitch End Hz",            "pitchEndHz",             20.0f,  200.0f,   50.0f,   "",                                      10.0f,  1.0f)   \
+    X(Float,  pitchTauMs,             "pitchTauMs",             "Pitch Tau Ms",            "pitchTauMs",             1.0f,   100.0f,   20.0f,   "",                                      5.0f,   0.25f)  \
+    X(Float,  attackMs,               "attackMs",               "Attack Ms",               "attackMs",               0.0f,   50.0f,    0.0f,    "",                                      2.0f,   0.1f)   \
+    X(Float,  t12Ms,                  "t12Ms",                  "T12 Ms",                  "t12Ms",                  1.0f,   50.0f,    5.0f,    "",                                      2.0f,   0.1f)   \
+    X(Float,  t24Ms,                  "t24Ms",                  "T24 Ms",                  "t24Ms",                  5.0f,   200.0f,   20.0f,   "",                                      5.0f,   0.25f)  \
+    X(Float,  tailMsToMinus60Db,      "tailMsToMinus60Db",      "Tail Ms To -60dB",        "tailMsToMinus60Db",      10.0f,  500.0f,   70.0f,   "",                                      20.0f,  1.0f)   \
+    X(Float,  clickDecayMs,           "clickDecayMs",           "Click Decay Ms",          "clickDecayMs",           1.0f,   20.0f,    3.0f,    "",                                      1.0f,   0.1f)   \
+    X(Float,  clickHPFHz,             "clickHPFHz",             "Click HPF Hz",            "clickHPFHz",             500.0f, 10000.0f, 2000.0f, "",                                      400.0f, 25.0f)  \
+    X(Float,  velocitySensitivity,    "velocitySensitivity",    "Velocity Sensitivity",    "velocitySensitivity",    0.0f,   1.0f,     1.0f,    "",                                      0.05f,  0.005f) \
+    X(Choice, bodyOscType,            "bodyOscType",            "Body Osc Type",           "bodyOscType",            0.0f,   3.0f,     0.0f,    "Sine|Triangle|Saw|Square",              0.0f,   0.0f)   \
+    X(Float,  keyTracking,            "keyTracking",            "Key Tracking",            "keyTracking",            -12.0f, 12.0f,    0.0f,    "",                                      0.0f,   0.0f)   \
+    X(Bool,   retriggerMode,          "retriggerMode",          "Retrigger Mode",          "retriggerMode",          0.0f,   1.0f,     0.0f,    "",                                      0.0f,   0.0f)   \
+    X(Choice, distortionType,         "distortionType",         "Distortion Type",         "distortionType",         0.0f,   2.0f,     0.0f,    "Tanh|Hard Clip|Asymmetric",             0.0f,   0.0f)   \
+    X(Choice, distortionAntialiasing, "distortionAntialiasing", "Distortion Antialiasing", "distortionAntialiasing", 0.0f,   2.0f,     0.0f,    "Off|ADAA 1st Order|ADAA 2nd Order",     0.0f,   0.0f)   \
+    X(Float,  drive,                  "drive",                  "Drive",                   "drive",                  0.0f,   1.0f,     0.5f,    "",                                      0.05f,  0.005f) \
+    X(Float,  asymmetry,              "asymmetry",              "Asymmetry",               "asymmetry",              0.0f,   1.0f,     0.0f,    "",                                      0.05f,  0.005f) \
+    X(Float,  outputGainDb,           "outputGain",             "Output Gain",             "outputGainDb",           -12.0f, 12.0f,    0.0f,    "",                                      1.0f,   0.1f)   \
+    X(Float,  outputHPFHz,            "outputHPFHz",            "Output HPF Hz",           "outputHPFHz",            20.0f,  200.0f,   20.0f,   "",                                      10.0f,  1.0f)   \
+    X(Bool,   limiterEnabled,         "limiterEnabled",         "Limiter Enabled",         "limiterEnabled",         0.0f,   1.0f,     1.0f,    "",                                      0.0f,   0.0f)   \
+    X(Choice, limiterMode,            "limiterMode",            "Limiter Mode",            "limiterMode",            0.0f,   1.0f,     0.0f,    "Soft Clip|True Peak",                   0.0f,   0.0f)
+
+namespace KickParameterSchema
+{
+    enum class Kind
+    {
+        Float,
+        Choice,
+        Bool
+    };
+
+    // Member types per kind (used as KickParameterSchema::<kind>Type)
+    using FloatType = float;
+    using ChoiceType = int;
+    using BoolType = bool;
+
+    struct Spec
+    {
+        Kind kind;
+        const char* id;
+        const char* name;
+        const char* jsonKey;
+        float minValue;
+        float maxValue;
+        float defaultValue;
+        const char* choices;
+        float fitStep;
+        float fitMinStep;
+
+        constexpr bool isFitted() const { return fitStep > 0.0f; }
+    };
+
+   #define KICK_PARAMETER_INDEX(kind, member, ...) member,
+    enum Index
+    {
+        KICK_PARAMETERS(KICK_PARAMETER_INDEX)
+        numParameters
+    };
+   #undef KICK_PARAMETER_INDEX
+
+   #define KICK_PARAMETER_SPEC(kind, member, id, name, jsonKey, minValue, maxValue, defaultValue, choices, fitStep, fitMinStep) \
+        Spec{ Kind::kind, id, name, jsonKey, minValue, maxValue, defaultValue, choices, fitStep, fitMinStep },
+    constexpr std::array<Spec, numParameters> specs{{ KICK_PARAMETERS(KICK_PARAMETER_SPEC) }};
+   #undef KICK_PARAMETER_SPEC
+}
@@ -0,0 +1,154 @@
+#include "KickParams.h"
+#include <cmath>
+
+float KickParams::get(int index) const
+{
+    switch (index)
+    {
+       #define KICK_PARAMETER_GET(kind, member, ...) \
+        case KickParameterSchema::member: return static_cast<float>(member);
+        KICK_PARAMETERS(KICK_PARAMETER_GET)
+       #undef KICK_PARAMETER_GET
+        default: break;
+    }
+
+    jassertfalse;
+    return 0.0f;
+}
+
+namespace
+{
+    template <typename Type>
+    Type fromFloat(float value);
+
+    template <>
+    float fromFloat<float>(float value) { return value; }
+
+    template <>
+    int fromFloat<int>(float value) { return (int)std::lround(value); }
+
+    template <>
+    bool fromFloat<bool>(float value) { return value >= 0.5f; }
+}
+
+void KickParams::set(int index, float value)
+{
+    switch (index)
+    {
+       #define KICK_PARAMETER_SET(kind, member, ...) \
+        case KickParameterSchema::member: member = fromFloat<KickParameterSchema::kind##Type>(value); return;
+        KICK_PARAMETERS(KICK_PARAMETER_SET)
+       #undef KICK_PARAMETER_SET
+        default: break;
+    }
+
+    jassertfalse;
+}
+
+bool KickParams::operator== (const KickParams& other) const
+{
+   #define KICK_PARAMETER_EQUAL(kind, member, ...) \
+    if (member != other.member) return false;
+    KICK_PARAMETERS(KICK_PARAMETER_EQUAL)
+   #undef KICK_PARAMETER_EQUAL
+
+    return noiseSeed == other.noiseSeed;
+}
+
+KickParams KickParams::clamped() const
+{
+    KickParams p = *this;
+    for (int index = 0; index < KickParameterSchema::numParameters; ++index)
+    {
+        const auto& spec = KickParameterSchema::specs[(size_t)index];
+        p.set(index, juce::jlimit(spec.minValue, spec.maxValue, get(index)));
+    }
+    return p;
+}
+
+KickParams KickParams::fromParameterValues(const float* values)
+{
+    KickParams p;
+    for (int index = 0; index < KickParameterSchema::numParameters; ++index)
+        p.set(index, values[index]);
+    return p;
+}
+
+juce::String KickParams::toJson() const
+{
+    auto obj = juce::DynamicObject::Ptr(new juce::DynamicObject());
+    for (int index = 0; index < KickParameterSchema::numParameters; ++index)
+    {
+        const auto& spec = KickParameterSchema::specs[(size_t)index];
+        const float value = get(index);
+
+        if (spec.kind == KickParameterSchema::Kind::Choice)
+            obj->setProperty(spec.jsonKey, (int)std::lround(value));
+        else if (spec.kind == KickParameterSchema::Kind::Bool)
+            obj->setProperty(spec.jsonKey, value >= 0.5f);
+        else
+            obj->setProperty(spec.jsonKey, value);
+    }
+    obj->setProperty("noiseSeed", noiseSeed);
+    return juce::JSON::toString(juce::var(obj.get()), true);
+}
+
+bool KickParams::readJsonValue(const juce::var& obj, int index, float& value)
+{
+    auto* o = obj.getDynamicObject();
+    if (o == nullptr)
+        return false;
+
+    const auto& spec = KickParameterSchema::specs[(size_t)index];
+    juce::Identifier key(spec.jsonKey);
+    if (!o->hasProperty(key))
+        key = juce::Identifier(spec.id);
+    if (!o->hasProperty(key))
+        return false;
+
+    const auto& property = o->getProperty(key);
+    if (spec.kind == KickParameterSchema::Kind::Choice)
+        value = (float)(int)property;
+    else if (spec.kind == KickParameterSchema::Kind::Bool)
+        value = (bool)property ? 1.0f : 0.0f;
+    else
+        value = (float)property;
+    return true;
+}
+
+juce::String KickParams::getSchemaSignature()
+{
+    juce::StringArray ids;
+    for (const auto& spec : KickParameterSchema::specs)
+        ids.add(spec.id);
+    return ids.joinIntoString(",");
+}
+
+KickParams KickParams::fromJson(const juce::var& obj)
+{
+    KickParams p;
+    for (int index = 0; index < KickParameterSchema::numParameters; ++index)
+    {
+        float value = 0.0f;
+        if (readJsonValue(obj, index, value))
+            p.set(index, value);
+    }
+    p.noiseSeed = (int)obj.getProperty("noiseSeed", p.noiseSeed);
+    return p;
+}
+
+KickParams loadKickParamsJson(const juce::File& file)
+{
+    if (!file.existsAsFile())
+        return KickParams{};
+    auto text = file.loadFileAsString();
+    auto parsed = juce::JSON::parse(text);
+    if (parsed.isVoid() || parsed.isUndefined())
+        return KickParams{};
+    return KickParams::fromJson(parsed);
+}
+
+void saveKickParamsJson(const juce::File& file, const KickParams& params)
+{
+    file.replaceWithText(params.toJson());
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "JuceHeader.h"
+#include "KickParameterSchema.h"
+
+/**
+ * KickParams - Typed snapshot of every KickSynth parameter
+ *
+ * The members are generated from KICK_PARAMETERS, so the plugin (which fills a snapshot from its
+ * parameter atomics), the render engine, the JSON files and kick_fit all see the same fields,
+ * ranges and defaults.
+ */
+struct KickParams
+{
+   #define KICK_PARAMETER_MEMBER(kind, member, id, name, jsonKey, minValue, maxValue, defaultValue, ...) \
+        KickParameterSchema::kind##Type member = static_cast<KickParameterSchema::kind##Type>(defaultValue);
+    KICK_PARAMETERS(KICK_PARAMETER_MEMBER)
+   #undef KICK_PARAMETER_MEMBER
+
+    // Render setting, not a plugin parameter: seed of the click noise
+    int noiseSeed = 1;
+
+    // Value of a parameter by schema index, as a float (choices are indices, bools 0/1)
+    float get(int index) const;
+
+    // Sets a parameter by schema index; choices are rounded and bools thresholded at 0.5
+    void set(int index, float value);
+
+    // Every parameter and the noise seed match exactly
+    bool operator== (const KickParams& other) const;
+    bool operator!= (const KickParams& other) const { return ! (*this == other); }
+
+    // Copy with every parameter clamped to its schema range
+    KickParams clamped() const;
+
+    // Builds a snapshot from plain parameter values in schema order (e.g. the APVTS atomics)
+    static KickParams fromParameterValues(const float* values);
+
+    juce::String toJson() const;
+    static KickParams fromJson(const juce::var& obj);
+
+    // Reads one parameter from a JSON object (jsonKey first, then the parameter ID)
+    static bool readJsonValue(const juce::var& obj, int index, float& value);
+
+    // Parameter IDs in schema order, joined by commas: files that store parameters by schema index
+    // (kick_fit's evaluation cache, the inverse model) record it and refuse to load on a mismatch
+    static juce::String getSchemaSignature();
+};
+
+KickParams loadKickParamsJson(const juce::File& file);
+void saveKickParamsJson(const juce::File& file, const KickParams& params);
@@ -0,0 +1,264 @@
+#include "KickPreview.h"
+#include "PluginProcessor.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <utility>
+
+//==============================================================================
+KickPreviewRenderer::KickPreviewRenderer()
+    : juce::ThreadPoolJob("KickSynth preview")
+{
+}
+
+KickPreviewRenderer::~KickPreviewRenderer()
+{
+    stopTimer();
+
+    // Dequeue the job, or interrupt it and wait for as long as it takes (a negative timeout): it sees
+    // shouldExit() at its next abort check, and must have left the pool before this object goes.
+    // Skipped if no job was ever queued, so closing an editor never creates the pool.
+    if (hasQueuedJob)
+    {
+        const bool removed = sharedResources->getWorkerPool().removeJob(this, true, -1);
+        jassert(removed);
+        juce::ignoreUnused(removed);
+    }
+}
+
+void KickPreviewRenderer::requestRender(const KickParams& params, double sampleRate)
+{
+    {
+        const juce::ScopedLock sl(requestLock);
+        requestedParams = params;
+        requestedSampleRate = sampleRate;
+        ++requestGeneration;
+    }
+
+    // Debounce: each request restarts the quiet period
+    startTimer(debounceMs);
+}
+
+void KickPreviewRenderer::timerCallback()
+{
+    // A superseded job may still be winding down; try again once it has left the pool
+    auto& pool = sharedResources->getWorkerPool();
+    if (pool.contains(this))
+        return;
+
+    stopTimer();
+    pool.addJob(this, false);
+    hasQueuedJob = true;
+}
+
+bool KickPreviewRenderer::getLatestResult(Result& destination) const
+{
+    const juce::ScopedLock sl(resultLock);
+    if (! hasResult)
+        return false;
+
+    destination.params = latestResult.params;
+    destination.waveform.makeCopyOf(latestResult.waveform);
+    destination.sampleRate = latestResult.sampleRate;
+    destination.metrics = latestResult.metrics;
+    destination.elapsedMs = latestResult.elapsedMs;
+    return true;
+}
+
+juce::ThreadPoolJob::JobStatus KickPreviewRenderer::runJob()
+{
+    KickParams params;
+    double sampleRate = 0.0;
+    uint32_t generation = 0;
+    {
+        const juce::ScopedLock sl(requestLock);
+        params = requestedParams.clamped();
+        sampleRate = requestedSampleRate;
+        generation = requestGeneration.load();
+    }
+
+    // A newer request re-arms the debounce timer, which queues the job again
+    const auto shouldAbort = [this, generation]() { return shouldExit() || requestGeneration.load() != generation; };
+    const double startMs = juce::Time::getMillisecondCounterHiRes();
+
+    if (sampleRate != engineSampleRate)
+    {
+        engine.prepare(sampleRate);
+        engineSampleRate = sampleRate;
+    }
+
+    renderBuffer.setSize(1, KickRenderEngine::getRenderLength(params, sampleRate), false, false, true);
+
+    if (! engine.render(params, 1.0f, renderBuffer, shouldAbort))
+        return jobHasFinished;
+
+    const auto analysis = KickAnalyzer::analyzeBuffer(renderBuffer, sampleRate, analysisWorkspace, shouldAbort);
+    if (analysis.aborted || shouldAbort())
+        return jobHasFinished;
+
+    {
+        const juce::ScopedLock sl(resultLock);
+        latestResult.params = params;
+        latestResult.waveform.makeCopyOf(renderBuffer);
+        latestResult.sampleRate = sampleRate;
+        latestResult.metrics = analysis.metrics;
+        latestResult.elapsedMs = juce::Time::getMillisecondCounterHiRes() - startMs;
+        hasResult = true;
+    }
+
+    sendChangeMessage();
+    return jobHasFinished;
+}
+
+//==============================================================================
+KickPreviewComponent::KickPreviewComponent(KickSynthAudioProcessor& processor)
+    : audioProcessor(processor)
+{
+    renderer.addChangeListener(this);
+    startTimerHz(snapshotPollHz);
+}
+
+KickPreviewComponent::~KickPreviewComponent()
+{
+    stopTimer();
+    renderer.removeChangeListener(this);
+}
+
+void KickPreviewComponent::timerCallback()
+{
+    const auto snapshot = audioProcessor.getParameterSnapshot();
+    if (hasRequested && snapshot == requestedParams)
+        return;
+
+    const double sampleRate = audioProcessor.getSampleRate() > 0.0 ? audioProcessor.getSampleRate() : 48000.0;
+    renderer.requestRender(snapshot, sampleRate);
+    requestedParams = snapshot;
+    hasRequested = true;
+    pending = true;
+    repaint();
+}
+
+void KickPreviewComponent::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    if (! renderer.getLatestResult(preview))
+        return;
+
+    hasPreview = true;
+    pending = preview.params != requestedParams.clamped();
+    rebuildWaveformPath();
+    repaint();
+}
+
+juce::Rectangle<int> KickPreviewComponent::getWaveformArea() const
+{
+    auto bounds = getLocalBounds().reduced(8);
+    bounds.removeFromTop(24);
+    return bounds.removeFromTop(juce::jmin(200, bounds.getHeight() / 2));
+}
+
+void KickPreviewComponent::resized()
+{
+    rebuildWaveformPath();
+}
+
+void KickPreviewComponent::rebuildWaveformPath()
+{
+    waveformPath.clear();
+    if (! hasPreview || preview.waveform.getNumSamples() == 0)
+        return;
+
+    // One min/max segment per pixel column, full scale = half the area height
+    const auto area = getWaveformArea().toFloat();
+    const int columns = juce::jmax(1, (int)area.getWidth());
+    const float* samples = preview.waveform.getReadPointer(0);
+    const int numSamples = preview.waveform.getNumSamples();
+    const float centreY = area.getCentreY();
+    const float halfHeight = area.getHeight() * 0.5f;
+
+    waveformPath.preallocateSpace(columns * 6);
+    for (int column = 0; column < columns; ++column)
+    {
+        const int start = (int)((int64_t)column * numSamples / columns);
+        const int end = juce::jmax(start + 1, (int)((int64_t)(column + 1) * numSamples / columns));
+
+        float low = samples[start];
+        float high = samples[start];
+        for (int i = start + 1; i < end && i < numSamples; ++i)
+        {
+            low = juce::jmin(low, samples[i]);
+            high = juce::jmax(high, samples[i]);
+        }
+
+        const float x = area.getX() + (float)column + 0.5f;
+        waveformPath.startNewSubPath(x, centreY - juce::jlimit(-1.0f, 1.0f, high) * halfHeight);
+        waveformPath.lineTo(x, centreY - juce::jlimit(-1.0f, 1.0f, low) * halfHeight + 1.0f);
+    }
+}
+
+void KickPreviewComponent::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds();
+    g.setColour(juce::Colours::black.withAlpha(0.35f));
+    g.fillRect(bounds);
+
+    auto content = bounds.reduced(8);
+    auto header = content.removeFromTop(24);
+    g.setColour(juce::Colours::white);
+    g.setFont(15.0f);
+    g.drawText("Preview", header, juce::Justification::centredLeft);
+
+    g.setColour(juce::Colours::lightgrey);
+    g.setFont(12.0f);
+    juce::String status;
+    if (pending)
+        status = "rendering...";
+    else if (hasPreview)
+        status = juce::String(preview.elapsedMs, 1) + " ms";
+    g.drawText(status, header, juce::Justification::centredRight);
+
+    // Waveform
+    const auto waveformArea = getWaveformArea();
+    g.setColour(juce::Colours::black.withAlpha(0.4f));
+    g.fillRect(waveformArea);
+    g.setColour(juce::Colours::grey);
+    g.drawHorizontalLine(waveformArea.getCentreY(), (float)waveformArea.getX(), (float)waveformArea.getRight());
+    g.setColour(juce::Colours::orange.withAlpha(pending ? 0.4f : 1.0f));
+    g.strokePath(waveformPath, juce::PathStrokeType(1.0f));
+
+    if (! hasPreview)
+        return;
+
+    // Metrics readout, two columns of label/value rows
+    const auto& m = preview.metrics;
+    const std::pair<const char*, juce::String> readouts[] = {
+        { "Peak",          juce::String(m.peak_dbfs, 1) + " dBFS" },
+        { "True peak",     juce::String(m.true_peak_dbfs, 1) + " dBFS" },
+        { "Attack",        juce::String(m.attack_ms, 2) + " ms" },
+        { "Crest",         juce::String(m.crest_db, 1) + " dB" },
+        { "T12",           juce::String(m.t12_ms, 1) + " ms" },
+        { "T24",           juce::String(m.t24_ms, 1) + " ms" },
+        { "Tail -60 dB",   juce::String(m.tail_ms_to_minus60db, 1) + " ms" },
+        { "Pitch tau",     juce::String(m.pitch_tau_ms, 1) + " ms" },
+        { "Pitch start",   juce::String(m.pitch_start_hz, 1) + " Hz" },
+        { "Pitch end",     juce::String(m.pitch_end_hz, 1) + " Hz" },
+        { "Sub / body",    juce::String(m.sub_20_60_over_body_60_200, 3) },
+        { "Click / body",  juce::String(m.click_2k_10k_over_body_60_200, 3) },
+    };
+
+    content.removeFromTop(waveformArea.getHeight() + 10);
+    const int rowHeight = 20;
+    const int columnWidth = content.getWidth() / 2;
+    const int numRows = (int)std::size(readouts) / 2;
+
+    g.setFont(13.0f);
+    for (int i = 0; i < (int)std::size(readouts); ++i)
+    {
+        const juce::Rectangle<int> cell(content.getX() + (i / numRows) * columnWidth,
+                                        content.getY() + (i % numRows) * rowHeight,
+                                        columnWidth - 10, rowHeight);
+        g.setColour(juce::Colours::lightgrey);
+        g.drawText(readouts[i].first, cell, juce::Justification::centredLeft);
+        g.setColour(pending ? juce::Colours::grey : juce::Colours::white);
+        g.drawText(readouts[i].second, cell, juce::Justification::centredRight);
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "JuceHeader.h"
+#include "KickParams.h"
+#include "KickMetrics.h"
+#include "KickRenderEngine.h"
+#include "SharedResources.h"
+#include <atomic>
+#include <cstdint>
+
+class KickSynthAudioProcessor;
+
+/**
+ * KickPreviewRenderer - Offline preview of the current parameter snapshot for the editor
+ *
+ * Renders one kick (note 60, velocity 1) with its own KickRenderEngine and runs KickAnalyzer on it
+ * as a job on the process-wide SharedResources worker pool, entirely off the audio thread. Requests
+ * are debounced (the job is queued once no new request has arrived for debounceMs) and every
+ * request supersedes the previous one: a generation counter is polled between render slices and
+ * analysis stages, so a stale job returns its worker within a few milliseconds. Finished previews
+ * are announced with an (asynchronous) change message.
+ */
+class KickPreviewRenderer : public juce::ChangeBroadcaster,
+                            private juce::Timer,
+                            private juce::ThreadPoolJob
+{
+public:
+    struct Result
+    {
+        KickParams params;
+        juce::AudioBuffer<float> waveform; // mono, starting at the note-on
+        double sampleRate = 0.0;
+        KickMetrics metrics;
+        double elapsedMs = 0.0; // render + analysis wall time
+    };
+
+    KickPreviewRenderer();
+    ~KickPreviewRenderer() override;
+
+    // Queues a preview of params, cancelling any queued or running one
+    void requestRender(const KickParams& params, double sampleRate);
+
+    // Copies the latest finished preview; false until the first one completes
+    bool getLatestResult(Result& destination) const;
+
+private:
+    void timerCallback() override;
+    JobStatus runJob() override;
+
+    static constexpr int debounceMs = 120;
+
+    juce::SharedResourcePointer<SharedResources> sharedResources;
+
+    juce::CriticalSection requestLock;
+    KickParams requestedParams;
+    double requestedSampleRate = 48000.0;
+    std::atomic<uint32_t> requestGeneration { 0 };
+    bool hasQueuedJob = false; // message thread only
+
+    // Job only
+    KickRenderEngine engine;
+    double engineSampleRate = 0.0;
+    juce::AudioBuffer<float> renderBuffer;
+    AnalysisWorkspace analysisWorkspace;
+
+    juce::CriticalSection resultLock;
+    Result latestResult;
+    bool hasResult = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(KickPreviewRenderer)
+};
+
+/**
+ * KickPreviewComponent - Waveform and metrics readout of the preview render
+ *
+ * Polls the processor's parameter snapshot from a message-thread timer (the audio thread is never
+ * involved) and hands changed snapshots to a KickPreviewRenderer. While a newer snapshot is pending
+ * the last preview stays on screen, dimmed.
+ */
+class KickPreviewComponent : public juce::Component,
+                             private juce::ChangeListener,
+                             private juce::Timer
+{
+public:
+    explicit KickPreviewComponent(KickSynthAudioProcessor& processor);
+    ~KickPreviewComponent() override;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    void timerCallback() override;
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+    void rebuildWaveformPath();
+
+    juce::Rectangle<int> getWaveformArea() const;
+
+    static constexpr int snapshotPollHz = 30;
+
+    KickSynthAudioProcessor& audioProcessor;
+    KickPreviewRenderer renderer;
+
+    KickParams requestedParams;
+    bool hasRequested = false;
+    bool pending = false;
+
+    KickPreviewRenderer::Result preview;
+    bool hasPreview = false;
+    juce::Path waveformPath;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(KickPreviewComponent)
+};
@@ -3,9 +3,9 @@
 
 //==============================================================================
 KickSynthAudioProcessorEditor::KickSynthAudioProcessorEditor (KickSynthAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
+    : AudioProcessorEditor (&p), audioProcessor (p), previewComponent (p)
 {
-    setSize (800, 600);
+    setSize (960, 820);
     
     // Setup sliders
     auto setupSlider = [this](juce::Slider& slider, juce::Label& label, const juce::String& name, 
@@ -49,12 +49,23 @@ KickSynthAudioProcessorEditor::KickSynthAudioProcessorEditor (KickSynthAudioProc
     // Setup combos
     bodyOscTypeCombo.addItem("Sine", 1);
     bodyOscTypeCombo.addItem("Triangle", 2);
+    bodyOscTypeCombo.addItem("Saw", 3);
+    bodyOscTypeCombo.addItem("Square", 4);
     addAndMakeVisible(bodyOscTypeCombo);
     
     distortionTypeCombo.addItem("Tanh", 1);
     distortionTypeCombo.addItem("Hard Clip", 2);
     distortionTypeCombo.addItem("Asymmetric", 3);
     addAndMakeVisible(distortionTypeCombo);
+
+    distortionAntialiasingCombo.addItem("AA Off", 1);
+    distortionAntialiasingCombo.addItem("ADAA 1st Order", 2);
+    distortionAntialiasingCombo.addItem("ADAA 2nd Order", 3);
+    addAndMakeVisible(distortionAntialiasingCombo);
+
+    limiterModeCombo.addItem("Soft Clip", 1);
+    limiterModeCombo.addItem("True Peak", 2);
+    addAndMakeVisible(limiterModeCombo);
     
     // Setup buttons
     retriggerModeButton.setButtonText("Retrigger Mode");
@@ -87,54 +98,13 @@ KickSynthAudioProcessorEditor::KickSynthAudioProcessorEditor (KickSynthAudioProc
             if (parsed.isVoid() || parsed.isUndefined())
                 return;
 
-            auto* obj = parsed.getDynamicObject();
-            if (obj == nullptr)
-                return;
-
-            auto setFloatIfPresent = [&](const juce::String& jsonKey, const juce::String& paramId)
+            // Only the keys present in the file change the corresponding parameters
+            for (int index = 0; index < KickParameterSchema::numParameters; ++index)
             {
-                if (obj->hasProperty(jsonKey))
-                    setParamValue(paramId, (float)obj->getProperty(jsonKey));
-            };
-
-            auto setBoolIfPresent = [&](const juce::String& jsonKey, const juce::String& paramId)
-            {
-                if (obj->hasProperty(jsonKey))
-                    setParamValue(paramId, (bool)obj->getProperty(jsonKey) ? 1.0f : 0.0f);
-            };
-
-            auto setChoiceIfPresent = [&](const juce::String& jsonKey, const juce::String& paramId)
-            {
-                if (obj->hasProperty(jsonKey))
-                    setParamValue(paramId, (float)(int)obj->getProperty(jsonKey));
-            };
-
-            setFloatIfPresent("bodyLevel", "bodyLevel");
-            setFloatIfPresent("clickLevel", "clickLevel");
-            setFloatIfPresent("pitchStartHz", "pitchStartHz");
-            setFloatIfPresent("pitchEndHz", "pitchEndHz");
-            setFloatIfPresent("pitchTauMs", "pitchTauMs");
-            setFloatIfPresent("attackMs", "attackMs");
-            setFloatIfPresent("t12Ms", "t12Ms");
-            setFloatIfPresent("t24Ms", "t24Ms");
-            setFloatIfPresent("tailMsToMinus60Db", "tailMsToMinus60Db");
-            setFloatIfPresent("clickDecayMs", "clickDecayMs");
-            setFloatIfPresent("clickHPFHz", "clickHPFHz");
-            setFloatIfPresent("velocitySensitivity", "velocitySensitivity");
-            setFloatIfPresent("outputHPFHz", "outputHPFHz");
-            setFloatIfPresent("keyTracking", "keyTracking");
-            setFloatIfPresent("drive", "drive");
-            setFloatIfPresent("asymmetry", "asymmetry");
-
-            if (obj->hasProperty("outputGain"))
-                setParamValue("outputGain", (float)obj->getProperty("outputGain"));
-            else if (obj->hasProperty("outputGainDb"))
-                setParamValue("outputGain", (float)obj->getProperty("outputGainDb"));
-
-            setChoiceIfPresent("bodyOscType", "bodyOscType");
-            setChoiceIfPresent("distortionType", "distortionType");
-            setBoolIfPresent("retriggerMode", "retriggerMode");
-            setBoolIfPresent("limiterEnabled", "limiterEnabled");
+                float value = 0.0f;
+                if (KickParams::readJsonValue(parsed, index, value))
+                    setParamValue(KickParameterSchema::specs[(size_t)index].id, value);
+            }
         });
     };
 
@@ -148,38 +118,7 @@ KickSynthAudioProcessorEditor::KickSynthAudioProcessorEditor (KickSynthAudioProc
             if (file == juce::File())
                 return;
 
-            auto obj = juce::DynamicObject::Ptr(new juce::DynamicObject());
-            auto get = [&](const juce::String& paramId) -> float
-            {
-                if (auto* v = audioProcessor.getAPVTS().getRawParameterValue(paramId))
-                    return v->load();
-                return 0.0f;
-            };
-
-            obj->setProperty("bodyLevel", get("bodyLevel"));
-            obj->setProperty("clickLevel", get("clickLevel"));
-            obj->setProperty("pitchStartHz", get("pitchStartHz"));
-            obj->setProperty("pitchEndHz", get("pitchEndHz"));
-            obj->setProperty("pitchTauMs", get("pitchTauMs"));
-            obj->setProperty("attackMs", get("attackMs"));
-            obj->setProperty("t12Ms", get("t12Ms"));
-            obj->setProperty("t24Ms", get("t24Ms"));
-            obj->setProperty("tailMsToMinus60Db", get("tailMsToMinus60Db"));
-            obj->setProperty("clickDecayMs", get("clickDecayMs"));
-            obj->setProperty("clickHPFHz", get("clickHPFHz"));
-            obj->setProperty("velocitySensitivity", get("velocitySensitivity"));
-            obj->setProperty("bodyOscType", (int)get("bodyOscType"));
-            obj->setProperty("keyTracking", get("keyTracking"));
-            obj->setProperty("retriggerMode", get("retriggerMode") >= 0.5f);
-            obj->setProperty("distortionType", (int)get("distortionType"));
-            obj->setProperty("drive", get("drive"));
-            obj->setProperty("asymmetry", get("asymmetry"));
-            obj->setProperty("outputGain", get("outputGain"));
-            obj->setProperty("outputGainDb", get("outputGain"));
-            obj->setProperty("outputHPFHz", get("outputHPFHz"));
-            obj->setProperty("limiterEnabled", get("limiterEnabled") >= 0.5f);
-
-            file.replaceWithText(juce::JSON::toString(juce::var(obj.get()), true));
+            file.replaceWithText(audioProcessor.getParameterSnapshot().toJson());
         });
     };
     
@@ -222,10 +161,16 @@ KickSynthAudioProcessorEditor::KickSynthAudioProcessorEditor (KickSynthAudioProc
         audioProcessor.getAPVTS(), "bodyOscType", bodyOscTypeCombo);
     distortionTypeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
         audioProcessor.getAPVTS(), "distortionType", distortionTypeCombo);
+    distortionAntialiasingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getAPVTS(), "distortionAntialiasing", distortionAntialiasingCombo);
+    limiterModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getAPVTS(), "limiterMode", limiterModeCombo);
     retriggerModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
         audioProcessor.getAPVTS(), "retriggerMode", retriggerModeButton);
     limiterEnabledAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
         audioProcessor.getAPVTS(), "limiterEnabled", limiterEnabledButton);
+    
+    addAndMakeVisible(previewComponent);
 }
 
 KickSynthAudioProcessorEditor::~KickSynthAudioProcessorEditor()
@@ -293,6 +238,9 @@ void KickSynthAudioProcessorEditor::resized()
     x += sliderWidth + spacing;
     
     // Row 5: Distortion
+    // Preview panel, right of rows 1-4
+    previewComponent.setBounds(bounds.getX() + 470, bounds.getY(), bounds.getWidth() - 470, 4 * sliderHeight + 3 * 30);
+    
     x = bounds.getX();
     y += sliderHeight + 30;
     driveSlider.setBounds(x, y, sliderWidth, sliderHeight);
@@ -301,6 +249,10 @@ void KickSynthAudioProcessorEditor::resized()
     x += sliderWidth + spacing;
     distortionTypeCombo.setBounds(x, y, sliderWidth, 30);
     x += sliderWidth + spacing;
+    distortionAntialiasingCombo.setBounds(x, y, sliderWidth, 30);
+    x += sliderWidth + spacing;
+    limiterModeCombo.setBounds(x, y, sliderWidth, 30);
+    x += sliderWidth + spacing;
     
     // Row 6: Output and misc
     x = bounds.getX();
@@ -2,6 +2,7 @@
 
 #include "JuceHeader.h"
 #include "PluginProcessor.h"
+#include "KickPreview.h"
 
 //==============================================================================
 class KickSynthAudioProcessorEditor : public juce::AudioProcessorEditor
@@ -42,9 +43,14 @@ private:
     
     juce::ComboBox bodyOscTypeCombo;
     juce::ComboBox distortionTypeCombo;
+    juce::ComboBox distortionAntialiasingCombo;
+    juce::ComboBox limiterModeCombo;
     juce::ToggleButton retriggerModeButton;
     juce::ToggleButton limiterEnabledButton;
     
+    // Background preview render and metrics of the current settings
+    KickPreviewComponent previewComponent;
+    
     // Attachments
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> bodyLevelAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> clickLevelAttachment;
@@ -65,6 +71,8 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> keyTrackingAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> bodyOscTypeAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> distortionTypeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> distortionAntialiasingAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> limiterModeAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> retriggerModeAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> limiterEnabledAttachment;
     
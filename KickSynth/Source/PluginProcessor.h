@@ -1,9 +1,9 @@
 #pragma once
 
 #include "JuceHeader.h"
-#include "DSP/KickVoice.h"
-#include "DSP/KickDistortion.h"
-#include "DSP/KickLimiter.h"
+#include "KickParams.h"
+#include "DSP/KickSignalChain.h"
+#include <array>
 #include <atomic>
 
 //==============================================================================
@@ -52,48 +52,24 @@ public:
     //==============================================================================
     juce::AudioProcessorValueTreeState& getAPVTS() { return apvts; }
 
+    // Current parameter values as a typed snapshot
+    KickParams getParameterSnapshot() const;
+
     // Get voice for visualization
-    KickVoice* getVoice() { return voices[0].get(); }
+    KickVoice* getVoice() { return &chain.getVoice(); }
 
 private:
     //==============================================================================
     juce::AudioProcessorValueTreeState apvts;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
-    // Voice management (monophonic for kick)
-    static constexpr int maxVoices = 1;
-    std::array<std::unique_ptr<KickVoice>, maxVoices> voices;
-    
-    // DSP modules
-    KickDistortion distortion;
-    KickLimiter limiter;
-    
-    // Sample rate
-    double currentSampleRate = 44100.0;
-    
-    // Parameter smoothing
-    juce::SmoothedValue<float> bodyLevelSmoothed;
-    juce::SmoothedValue<float> clickLevelSmoothed;
-    juce::SmoothedValue<float> pitchStartSmoothed;
-    juce::SmoothedValue<float> pitchEndSmoothed;
-    juce::SmoothedValue<float> pitchTauSmoothed;
-    juce::SmoothedValue<float> attackMsSmoothed;
-    juce::SmoothedValue<float> t12MsSmoothed;
-    juce::SmoothedValue<float> t24MsSmoothed;
-    juce::SmoothedValue<float> tailMsSmoothed;
-    juce::SmoothedValue<float> clickDecayMsSmoothed;
-    juce::SmoothedValue<float> clickHPFHzSmoothed;
-    juce::SmoothedValue<float> driveSmoothed;
-    juce::SmoothedValue<float> asymmetrySmoothed;
-    juce::SmoothedValue<float> outputGainSmoothed;
-    juce::SmoothedValue<float> outputHPFHzSmoothed;
-    juce::SmoothedValue<float> velocitySensitivitySmoothed;
-    
-    juce::dsp::IIR::Filter<float> outputHPF;
-    juce::dsp::IIR::Coefficients<float>::Ptr outputHPFCoeffs;
+    // Raw parameter values in schema order, cached once so the audio thread never looks up IDs
+    std::array<std::atomic<float>*, KickParameterSchema::numParameters> parameterValues{};
+
+    // Voice -> output HPF -> distortion -> limiter (monophonic for kick)
+    KickSignalChain chain;
     
-    void renderVoices(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages);
-    void updateVoiceParameters();
+    void handleMidi(juce::MidiBuffer& midiMessages);
     
     std::atomic<bool> goRequest{false};
     std::atomic<float> goVelocity{1.0f};
@@ -97,10 +97,12 @@ int main(int argc, char* argv[])
             std::cout << "tailMsToMinus60Db: " << suggestions.tailMsToMinus60Db << std::endl;
             std::cout << "clickDecayMs: " << suggestions.clickDecayMs << std::endl;
             std::cout << "clickHPFHz: " << suggestions.clickHPFHz << std::endl;
-            std::cout << "bodyOscType: " << (suggestions.bodyOscType == 0 ? "Sine" : "Triangle") << std::endl;
+            const auto oscTypeNames = juce::StringArray::fromTokens(
+                KickParameterSchema::specs[KickParameterSchema::bodyOscType].choices, "|", "");
+            std::cout << "bodyOscType: " << oscTypeNames[suggestions.bodyOscType] << std::endl;
             std::cout << "drive: " << suggestions.drive << std::endl;
             std::cout << "asymmetry: " << suggestions.asymmetry << std::endl;
-            std::cout << "outputGain: " << suggestions.outputGain << std::endl;
+            std::cout << "outputGainDb: " << suggestions.outputGainDb << std::endl;
         }
     }
     
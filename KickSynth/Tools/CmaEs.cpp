@@ -0,0 +1,259 @@
+#include "CmaEs.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace
+{
+    // Jacobi eigenvalue iteration for a small symmetric matrix: returns the eigenvalues, and the
+    // eigenvectors as the columns of vectors
+    std::vector<double> symmetricEigen(std::vector<std::vector<double>> a, std::vector<std::vector<double>>& vectors)
+    {
+        const int n = (int)a.size();
+        vectors.assign((size_t)n, std::vector<double>((size_t)n, 0.0));
+        for (int i = 0; i < n; ++i)
+            vectors[(size_t)i][(size_t)i] = 1.0;
+
+        for (int sweep = 0; sweep < 100; ++sweep)
+        {
+            double offDiagonal = 0.0;
+            for (int p = 0; p < n; ++p)
+                for (int q = p + 1; q < n; ++q)
+                    offDiagonal += a[(size_t)p][(size_t)q] * a[(size_t)p][(size_t)q];
+            if (offDiagonal < 1.0e-30)
+                break;
+
+            for (int p = 0; p < n; ++p)
+            {
+                for (int q = p + 1; q < n; ++q)
+                {
+                    const double apq = a[(size_t)p][(size_t)q];
+                    if (std::abs(apq) < 1.0e-300)
+                        continue;
+
+                    const double theta = (a[(size_t)q][(size_t)q] - a[(size_t)p][(size_t)p]) / (2.0 * apq);
+                    const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+                    const double c = 1.0 / std::sqrt(t * t + 1.0);
+                    const double s = t * c;
+
+                    for (int k = 0; k < n; ++k)
+                    {
+                        const double akp = a[(size_t)k][(size_t)p];
+                        const double akq = a[(size_t)k][(size_t)q];
+                        a[(size_t)k][(size_t)p] = c * akp - s * akq;
+                        a[(size_t)k][(size_t)q] = s * akp + c * akq;
+                    }
+                    for (int k = 0; k < n; ++k)
+                    {
+                        const double apk = a[(size_t)p][(size_t)k];
+                        const double aqk = a[(size_t)q][(size_t)k];
+                        a[(size_t)p][(size_t)k] = c * apk - s * aqk;
+                        a[(size_t)q][(size_t)k] = s * apk + c * aqk;
+                    }
+                    for (int k = 0; k < n; ++k)
+                    {
+                        const double vkp = vectors[(size_t)k][(size_t)p];
+                        const double vkq = vectors[(size_t)k][(size_t)q];
+                        vectors[(size_t)k][(size_t)p] = c * vkp - s * vkq;
+                        vectors[(size_t)k][(size_t)q] = s * vkp + c * vkq;
+                    }
+                }
+            }
+        }
+
+        std::vector<double> values((size_t)n);
+        for (int i = 0; i < n; ++i)
+            values[(size_t)i] = a[(size_t)i][(size_t)i];
+        return values;
+    }
+}
+
+CmaEs::CmaEs(const std::vector<double>& initialMean, double initialSigma, int populationSize, uint32_t seed)
+    : dimensions((int)initialMean.size()),
+      mean(initialMean),
+      sigma(initialSigma),
+      rng(seed)
+{
+    const double n = (double)dimensions;
+    lambda = populationSize > 0 ? populationSize : 4 + (int)std::floor(3.0 * std::log(n));
+    lambda = std::max(lambda, 2);
+    mu = lambda / 2;
+
+    // Log-linear recombination weights
+    weights.resize((size_t)mu);
+    for (int i = 0; i < mu; ++i)
+        weights[(size_t)i] = std::log(mu + 0.5) - std::log(i + 1.0);
+    const double weightSum = std::accumulate(weights.begin(), weights.end(), 0.0);
+    double weightSquares = 0.0;
+    for (auto& w : weights)
+    {
+        w /= weightSum;
+        weightSquares += w * w;
+    }
+    mueff = 1.0 / weightSquares;
+
+    cc = (4.0 + mueff / n) / (n + 4.0 + 2.0 * mueff / n);
+    cs = (mueff + 2.0) / (n + mueff + 5.0);
+    c1 = 2.0 / ((n + 1.3) * (n + 1.3) + mueff);
+    cmu = std::min(1.0 - c1, 2.0 * (mueff - 2.0 + 1.0 / mueff) / ((n + 2.0) * (n + 2.0) + mueff));
+    damps = 1.0 + 2.0 * std::max(0.0, std::sqrt((mueff - 1.0) / (n + 1.0)) - 1.0) + cs;
+    chiN = std::sqrt(n) * (1.0 - 1.0 / (4.0 * n) + 1.0 / (21.0 * n * n));
+
+    pc.assign((size_t)dimensions, 0.0);
+    ps.assign((size_t)dimensions, 0.0);
+    C.assign((size_t)dimensions, std::vector<double>((size_t)dimensions, 0.0));
+    B = C;
+    D.assign((size_t)dimensions, 1.0);
+    for (int i = 0; i < dimensions; ++i)
+    {
+        C[(size_t)i][(size_t)i] = 1.0;
+        B[(size_t)i][(size_t)i] = 1.0;
+    }
+}
+
+const std::vector<std::vector<double>>& CmaEs::ask()
+{
+    population.assign((size_t)lambda, std::vector<double>((size_t)dimensions, 0.0));
+    std::vector<double> scaled((size_t)dimensions);
+
+    // x = m + sigma * B * D * z
+    for (auto& x : population)
+    {
+        for (int i = 0; i < dimensions; ++i)
+            scaled[(size_t)i] = D[(size_t)i] * normal(rng);
+
+        for (int i = 0; i < dimensions; ++i)
+        {
+            double sum = 0.0;
+            for (int j = 0; j < dimensions; ++j)
+                sum += B[(size_t)i][(size_t)j] * scaled[(size_t)j];
+            x[(size_t)i] = mean[(size_t)i] + sigma * sum;
+        }
+    }
+
+    return population;
+}
+
+void CmaEs::tell(const std::vector<double>& fitness)
+{
+    const int n = dimensions;
+
+    std::vector<int> order((size_t)lambda);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return fitness[(size_t)a] < fitness[(size_t)b]; });
+
+    bestHistory.push_back(fitness[(size_t)order.front()]);
+    lastRange = fitness[(size_t)order.back()] - fitness[(size_t)order.front()];
+
+    // Recombination
+    const auto oldMean = mean;
+    std::fill(mean.begin(), mean.end(), 0.0);
+    for (int k = 0; k < mu; ++k)
+        for (int i = 0; i < n; ++i)
+            mean[(size_t)i] += weights[(size_t)k] * population[(size_t)order[(size_t)k]][(size_t)i];
+
+    std::vector<double> step((size_t)n);
+    for (int i = 0; i < n; ++i)
+        step[(size_t)i] = (mean[(size_t)i] - oldMean[(size_t)i]) / sigma;
+
+    // Step-size path, in the whitened coordinates C^-1/2 * step = B * D^-1 * B^T * step
+    std::vector<double> rotated((size_t)n, 0.0);
+    for (int j = 0; j < n; ++j)
+    {
+        double sum = 0.0;
+        for (int i = 0; i < n; ++i)
+            sum += B[(size_t)i][(size_t)j] * step[(size_t)i];
+        rotated[(size_t)j] = sum / D[(size_t)j];
+    }
+
+    const double psScale = std::sqrt(cs * (2.0 - cs) * mueff);
+    double psNorm = 0.0;
+    for (int i = 0; i < n; ++i)
+    {
+        double whitened = 0.0;
+        for (int j = 0; j < n; ++j)
+            whitened += B[(size_t)i][(size_t)j] * rotated[(size_t)j];
+        ps[(size_t)i] = (1.0 - cs) * ps[(size_t)i] + psScale * whitened;
+        psNorm += ps[(size_t)i] * ps[(size_t)i];
+    }
+    psNorm = std::sqrt(psNorm);
+
+    ++generation;
+    const double hsigThreshold = (1.4 + 2.0 / (n + 1.0)) * chiN;
+    const bool hsig = psNorm / std::sqrt(1.0 - std::pow(1.0 - cs, 2.0 * generation)) < hsigThreshold;
+
+    // Covariance path and rank-one + rank-mu update
+    const double pcScale = std::sqrt(cc * (2.0 - cc) * mueff);
+    for (int i = 0; i < n; ++i)
+        pc[(size_t)i] = (1.0 - cc) * pc[(size_t)i] + (hsig ? pcScale * step[(size_t)i] : 0.0);
+
+    const double oldWeight = 1.0 - c1 - cmu + (hsig ? 0.0 : c1 * cc * (2.0 - cc));
+    for (int i = 0; i < n; ++i)
+    {
+        for (int j = 0; j <= i; ++j)
+        {
+            double rankMu = 0.0;
+            for (int k = 0; k < mu; ++k)
+            {
+                const auto& x = population[(size_t)order[(size_t)k]];
+                rankMu += weights[(size_t)k] * (x[(size_t)i] - oldMean[(size_t)i]) * (x[(size_t)j] - oldMean[(size_t)j]);
+            }
+
+            const double value = oldWeight * C[(size_t)i][(size_t)j]
+                               + c1 * pc[(size_t)i] * pc[(size_t)j]
+                               + cmu * rankMu / (sigma * sigma);
+            C[(size_t)i][(size_t)j] = value;
+            C[(size_t)j][(size_t)i] = value;
+        }
+    }
+
+    sigma *= std::exp((cs / damps) * (psNorm / chiN - 1.0));
+
+    // The decomposition only needs refreshing every O(n / (c1 + cmu)) evaluations
+    if (generation - eigenGeneration > lambda / (c1 + cmu) / n / 10.0)
+        updateEigenDecomposition();
+}
+
+void CmaEs::updateEigenDecomposition()
+{
+    eigenGeneration = generation;
+
+    auto values = symmetricEigen(C, B);
+    for (int i = 0; i < dimensions; ++i)
+        D[(size_t)i] = std::sqrt(std::max(values[(size_t)i], 1.0e-20));
+}
+
+bool CmaEs::hasConverged(double tolX) const
+{
+    if (generation == 0)
+        return false;
+
+    // Step size: every coordinate's standard deviation below tolX
+    double maxStdDev = 0.0;
+    for (int i = 0; i < dimensions; ++i)
+        maxStdDev = std::max(maxStdDev, sigma * std::sqrt(C[(size_t)i][(size_t)i]));
+    if (maxStdDev < tolX)
+        return true;
+
+    // Flat fitness across a whole generation
+    if (lastRange <= 1.0e-12 * std::max(1.0, std::abs(bestHistory.back())))
+        return true;
+
+    // Condition number of C
+    const auto [minD, maxD] = std::minmax_element(D.begin(), D.end());
+    if (*maxD > 1.0e7 * *minD)
+        return true;
+
+    // Stagnation: the best of the last window is no better than the best of the window before it
+    const int window = 10 + (int)std::ceil(30.0 * dimensions / lambda);
+    if ((int)bestHistory.size() >= 2 * window)
+    {
+        const auto end = bestHistory.end();
+        const double recent = *std::min_element(end - window, end);
+        const double earlier = *std::min_element(end - 2 * window, end - window);
+        if (recent >= earlier)
+            return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/**
+ * CmaEs - Covariance matrix adaptation evolution strategy (minimisation)
+ *
+ * Ask/tell interface: ask() samples a generation, the caller scores every point (in any order, e.g.
+ * on several threads) and hands the scores back to tell() in the same order. The search space is
+ * unbounded; callers with box constraints repair the points they evaluate and add a penalty for the
+ * distance to the box. Default population and learning rates follow Hansen's tutorial
+ * ("The CMA Evolution Strategy: A Tutorial", 2016). All randomness comes from the seed, so a run
+ * is reproducible.
+ */
+class CmaEs
+{
+public:
+    // populationSize <= 0 picks the default 4 + 3 ln(n)
+    CmaEs(const std::vector<double>& initialMean, double initialSigma, int populationSize, uint32_t seed);
+
+    int getDimensions() const { return dimensions; }
+    int getPopulationSize() const { return lambda; }
+    int getGeneration() const { return generation; }
+    double getSigma() const { return sigma; }
+    const std::vector<double>& getMean() const { return mean; }
+
+    // Samples the next generation
+    const std::vector<std::vector<double>>& ask();
+
+    // Updates the distribution from the fitness of every point returned by the last ask()
+    void tell(const std::vector<double>& fitness);
+
+    // Step size collapsed below tolX, fitness flat or stagnating, or the covariance ill-conditioned
+    bool hasConverged(double tolX = 1.0e-4) const;
+
+private:
+    void updateEigenDecomposition();
+
+    int dimensions = 0;
+    int lambda = 0;
+    int mu = 0;
+    std::vector<double> weights;
+    double mueff = 0.0;
+    double cc = 0.0, cs = 0.0, c1 = 0.0, cmu = 0.0, damps = 0.0, chiN = 0.0;
+
+    std::vector<double> mean;
+    double sigma = 0.3;
+    std::vector<double> pc, ps;
+    std::vector<std::vector<double>> C, B; // covariance and its eigenvectors (columns)
+    std::vector<double> D;                 // square roots of the eigenvalues
+
+    std::vector<std::vector<double>> population;
+    int generation = 0;
+    int eigenGeneration = 0;
+
+    // Termination bookkeeping
+    std::vector<double> bestHistory; // best fitness per generation
+    double lastRange = 1.0;          // best-to-worst fitness spread of the last generation
+
+    std::mt19937 rng;
+    std::normal_distribution<double> normal { 0.0, 1.0 };
+};
@@ -0,0 +1,233 @@
+#include "KickBatchRenderEngine.h"
+#include "../Source/DSP/KickOscillator.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+void KickBatchRenderEngine::prepare(double rate)
+{
+    sampleRate = rate;
+    bodyDivider = KickVoice::getBodyDividerForSampleRate(rate);
+    upsamplerKernels = KickVoice::getUpsamplerKernels(*sharedResources, bodyDivider);
+    synthesis.setBodyRate(rate, bodyDivider, upsamplerKernels.get());
+
+    for (auto& chain : chains)
+        chain.prepare(rate);
+}
+
+bool KickBatchRenderEngine::areCompatible(const KickParams& a, const KickParams& b)
+{
+    // The oscillator shape is the only setting the lanes share (it picks the render kernel); key
+    // tracking and attack on/off reduce to exact per-lane arithmetic (a ratio of 1, an attack of 0)
+    const auto shapeOf = [](const KickParams& p) { return juce::jlimit(0, KickOscillator::numShapes - 1, p.bodyOscType); };
+    return shapeOf(a) == shapeOf(b);
+}
+
+std::vector<std::vector<int>> KickBatchRenderEngine::makeBatches(const std::vector<KickParams>& params, int maxLanes)
+{
+    maxLanes = juce::jlimit(1, numLanes, maxLanes);
+    std::vector<std::vector<int>> batches;
+    std::vector<int> openBatch(KickOscillator::numShapes, -1); // per shape, the pass still filling
+
+    for (int i = 0; i < (int)params.size(); ++i)
+    {
+        const int shape = juce::jlimit(0, KickOscillator::numShapes - 1, params[(size_t)i].bodyOscType);
+        int& open = openBatch[(size_t)shape];
+        if (open < 0 || (int)batches[(size_t)open].size() == maxLanes)
+        {
+            open = (int)batches.size();
+            batches.emplace_back();
+        }
+        batches[(size_t)open].push_back(i);
+    }
+
+    return batches;
+}
+
+void KickBatchRenderEngine::setUpControls(int numParams)
+{
+    // Each lane's voice has been triggered by startChain; its controls and click burst become one
+    // lane of the batch (spare lanes repeat the last set and are silenced after the note-on)
+    int burstLength = 0;
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        const auto laneControls = chains[(size_t)std::min(lane, numParams - 1)].getVoice().getControls();
+
+        controls.pitchStartHz[lane] = laneControls.pitchStartHz;
+        controls.pitchEndHz[lane] = laneControls.pitchEndHz;
+        controls.hasPitchTau[lane] = laneControls.hasPitchTau;
+        controls.pitchTauSeconds[lane] = laneControls.pitchTauSeconds;
+        controls.keyTrackingRatio[lane] = laneControls.keyTrackingRatio;
+        controls.attackMs[lane] = laneControls.attackMs;
+        controls.decay.t12Ms[lane] = laneControls.decay.t12Ms;
+        controls.decay.t24Ms[lane] = laneControls.decay.t24Ms;
+        controls.decay.t60FromPeakMs[lane] = laneControls.decay.t60FromPeakMs;
+        controls.tailLimitMs[lane] = laneControls.tailLimitMs;
+        controls.bodyLevel[lane] = laneControls.bodyLevel;
+        controls.clickLevel[lane] = laneControls.clickLevel;
+        controls.velocityScale[lane] = laneControls.velocityScale;
+        controls.oneShot[lane] = laneControls.oneShot;
+
+        burstLength = std::max(burstLength, laneControls.clickBurstLength);
+    }
+
+    // Past its own length a lane's burst plays zeros, which adds exactly what the voice adds once
+    // its burst has ended
+    clickBurst.assign((size_t)burstLength, Lanes(0.0f));
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        const auto laneControls = chains[(size_t)std::min(lane, numParams - 1)].getVoice().getControls();
+        for (int i = 0; i < laneControls.clickBurstLength; ++i)
+            clickBurst[(size_t)i][lane] = laneControls.clickBurst[i];
+    }
+    controls.clickBurst = clickBurst.data();
+    controls.clickBurstLength = burstLength;
+}
+
+int KickBatchRenderEngine::nextChunkEnd(const LaneOutput& lane, int position) const
+{
+    // KickRenderEngine's chunks: 64 samples from 0 up to the buffer length, then the latency
+    // compensation in 64-sample chunks of its own
+    if (position < lane.numSamples)
+        return std::min(lane.numSamples, (position / chunkSize + 1) * chunkSize);
+
+    const int offset = position - lane.numSamples;
+    return lane.numSamples + std::min(lane.latency, (offset / chunkSize + 1) * chunkSize);
+}
+
+void KickBatchRenderEngine::render(const KickParams* params, int numParams, float velocity,
+                                   juce::AudioBuffer<float>* const* buffers)
+{
+    jassert(numParams <= numLanes);
+    numParams = std::min(numParams, numLanes);
+    if (numParams <= 0)
+        return;
+
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        jassert(lane >= numParams || areCompatible(params[lane], params[0]));
+
+        auto& output = outputs[(size_t)lane];
+        output = LaneOutput();
+        if (lane >= numParams)
+        {
+            output.finished = true;
+            continue;
+        }
+
+        KickRenderEngine::startChain(chains[(size_t)lane], params[lane], velocity, layerMask);
+        if (buffers[lane]->getNumSamples() == 0)
+        {
+            output.finished = true;
+            continue;
+        }
+
+        auto& buffer = *buffers[lane];
+        buffer.clear();
+        output.data = buffer.getWritePointer(0);
+        output.numSamples = buffer.getNumSamples();
+        output.chainLatency = chains[(size_t)lane].getLatencySamples();
+        output.latency = std::min(output.chainLatency, output.numSamples);
+        output.end = output.numSamples + output.latency;
+    }
+
+    // Finished lanes (spare, or an empty buffer) stay silent from the note-on
+    setUpControls(numParams);
+    synthesis.noteOn(controls.pitchStartHz);
+    for (int lane = 0; lane < numLanes; ++lane)
+        if (outputs[(size_t)lane].finished)
+            synthesis.running[lane] = false;
+
+    const auto kernel = KickVoice::getRenderKernel<Lanes>(chains[0].getVoice().getBodyOscillatorType(),
+                                                          true, true, bodyDivider > 1);
+    bool voiceRunning = KickSampleTraits<Lanes>::anyOf(synthesis.running);
+
+    for (int position = 0;;)
+    {
+        // The next chunk ends where the first unfinished lane's chunk ends, so every lane's chunk
+        // boundaries fall on one
+        int chunkEnd = INT_MAX;
+        for (const auto& output : outputs)
+            if (!output.finished)
+                chunkEnd = std::min(chunkEnd, nextChunkEnd(output, position));
+        if (chunkEnd == INT_MAX)
+            break;
+
+        // Once every lane's voice has stopped the voice only outputs silence
+        const int length = chunkEnd - position;
+        if (voiceRunning)
+            voiceRunning = (synthesis.*kernel)(controls, voiceChunk.data(), length);
+        else
+            std::fill(voiceChunk.begin(), voiceChunk.begin() + length, Lanes(0.0f));
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            auto& output = outputs[(size_t)lane];
+            if (output.finished)
+                continue;
+
+            for (int i = 0; i < length; ++i)
+                output.chunk[(size_t)(position - output.chunkStart + i)] = voiceChunk[(size_t)i][lane];
+
+            if (nextChunkEnd(output, position) == chunkEnd)
+                finishChunk(lane, chunkEnd);
+
+            // A finished lane's voice needs no more samples
+            if (output.finished)
+                synthesis.running[lane] = false;
+        }
+
+        position = chunkEnd;
+    }
+
+    // Fan out to any extra channels
+    for (int lane = 0; lane < numParams; ++lane)
+    {
+        auto& buffer = *buffers[lane];
+        for (int channel = 1; channel < buffer.getNumChannels(); ++channel)
+            juce::FloatVectorOperations::copy(buffer.getWritePointer(channel), buffer.getReadPointer(0), buffer.getNumSamples());
+    }
+}
+
+void KickBatchRenderEngine::finishChunk(int lane, int chunkEnd)
+{
+    // The lane's chunk is complete: the effects run on it as KickSignalChain::renderChunk would
+    auto& output = outputs[(size_t)lane];
+    auto& chain = chains[(size_t)lane];
+    const int length = chunkEnd - output.chunkStart;
+    float* samples = output.chunk.data();
+
+    chain.beginChunk(length);
+    chain.renderEffects(samples, length);
+
+    // Chain sample n lands at n - latency (KickRenderEngine's latency compensation)
+    for (int i = 0; i < length; ++i)
+    {
+        const int n = output.chunkStart + i;
+        if (n >= output.latency)
+            output.data[n - output.latency] = samples[i];
+        if (n < output.numSamples)
+            output.sliceMax = std::max(output.sliceMax, std::abs(samples[i]));
+    }
+    output.chunkStart = chunkEnd;
+
+    // KickRenderEngine's silent-tail check at the end of each 256-sample slice
+    if (skipSilentTail && chunkEnd <= output.numSamples
+        && (chunkEnd % tailCheckInterval == 0 || chunkEnd == output.numSamples))
+    {
+        const int sliceStart = (chunkEnd - 1) / tailCheckInterval * tailCheckInterval;
+        if (output.silentCheckFrom < 0 && !synthesis.running[lane])
+            output.silentCheckFrom = chunkEnd + output.chainLatency;
+
+        if (output.silentCheckFrom >= 0 && sliceStart >= output.silentCheckFrom
+            && output.sliceMax < silenceThreshold)
+        {
+            // Stopped: the rest of the buffer, latency tail included, stays silent
+            output.finished = true;
+        }
+        output.sliceMax = 0.0f;
+    }
+
+    if (chunkEnd == output.end)
+        output.finished = true;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "KickLanes.h"
+#include "KickParams.h"
+#include "KickRenderEngine.h"
+#include "../Source/DSP/KickSignalChain.h"
+#include "../Source/DSP/KickVoice.h"
+#include <array>
+#include <memory>
+#include <vector>
+
+/**
+ * KickBatchRenderEngine - Renders up to numLanes parameter sets in one pass
+ *
+ * Same output as KickRenderEngine, bit for bit, for every lane. The voices run as the lanes of one
+ * KickVoice::Synthesis on KickLanes, through the kernels the plugin runs on float, so the per-sample
+ * loop is shared with KickVoice rather than copied. Each lane keeps its own KickSignalChain, set up
+ * by KickRenderEngine::startChain: its voice supplies the lane's controls and click burst, and its
+ * effects (output HPF, distortion, limiter) run on the lane's own 64-sample chunks, which keeps
+ * their state and chunk boundaries as in a single render.
+ *
+ * Lanes in one pass must share the body oscillator type (areCompatible, makeBatches); everything
+ * else, including the distortion and limiter settings and the buffer lengths, may differ per lane.
+ * Rendering stops when every lane has finished. There is no abort callback.
+ */
+class KickBatchRenderEngine
+{
+public:
+    static constexpr int numLanes = 8;
+
+    void prepare(double sampleRate);
+
+    // Renders params[lane] into *buffers[lane] for lane < numParams (numParams <= numLanes, all
+    // compatible); each buffer keeps its size, as with KickRenderEngine::render
+    void render(const KickParams* params, int numParams, float velocity, juce::AudioBuffer<float>* const* buffers);
+
+    // As KickRenderEngine::setSkipSilentTail and setLayerMask, for every lane
+    void setSkipSilentTail(bool shouldSkip) { skipSilentTail = shouldSkip; }
+    void setLayerMask(int mask) { layerMask = mask; }
+
+    // Whether two parameter sets can share a pass
+    static bool areCompatible(const KickParams& a, const KickParams& b);
+
+    // Splits params into passes of up to maxLanes (at most numLanes) compatible sets, as indices
+    // into params; sets keep their order within a pass and passes are ordered by their first set
+    static std::vector<std::vector<int>> makeBatches(const std::vector<KickParams>& params, int maxLanes = numLanes);
+
+private:
+    using Lanes = KickLanes<float, numLanes>;
+
+    static constexpr int chunkSize = KickSignalChain::controlBlockSize;
+    static constexpr int tailCheckInterval = 256;      // as KickRenderEngine
+    static constexpr float silenceThreshold = 1.0e-6f; // as KickRenderEngine
+
+    struct LaneOutput
+    {
+        float* data = nullptr;
+        int numSamples = 0;
+        int latency = 0;          // compensated, as KickRenderEngine: min(chain latency, numSamples)
+        int chainLatency = 0;
+        int end = 0;              // numSamples + latency: chain samples this lane renders
+        int chunkStart = 0;       // first chain sample of the chunk being collected
+        int silentCheckFrom = -1;
+        float sliceMax = 0.0f;
+        bool finished = false;
+        std::array<float, chunkSize> chunk {};
+    };
+
+    void setUpControls(int numParams);
+    int nextChunkEnd(const LaneOutput& lane, int position) const;
+    void finishChunk(int lane, int chunkEnd);
+
+    double sampleRate = 44100.0;
+    bool skipSilentTail = false;
+    int layerMask = KickRenderEngine::allLayers;
+
+    juce::SharedResourcePointer<SharedResources> sharedResources;
+    std::shared_ptr<const KickVoice::UpsamplerKernels> upsamplerKernels;
+    int bodyDivider = 1;
+
+    std::array<KickSignalChain, numLanes> chains;
+    KickVoice::Synthesis<Lanes> synthesis;
+    KickVoice::Controls<Lanes> controls;
+    std::vector<Lanes> clickBurst; // the lanes' bursts side by side, zero after each one ends
+
+    std::array<Lanes, chunkSize> voiceChunk {};
+    std::array<LaneOutput, numLanes> outputs;
+};
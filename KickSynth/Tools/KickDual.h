@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+
+/**
+ * KickDual - Forward-mode dual number with NumPartials partial derivatives
+ *
+ * Holds a value and its derivatives with respect to NumPartials inputs; arithmetic and the math
+ * functions below apply the chain rule, so a computation written for float or double that calls its
+ * math functions unqualified (`using std::exp; exp(x)`) yields the gradient of its result in the same
+ * pass. Comparisons look at the value only: branches follow the value, and the derivative is that of
+ * the branch taken (one-sided at kinks such as clamps).
+ */
+template <int NumPartials>
+class KickDual
+{
+public:
+    static constexpr int numPartials = NumPartials;
+
+    KickDual() = default;
+    KickDual(double constant) : value(constant) {} // implicit: constants mix freely with duals
+
+    // The input with the given index: derivative 1 with respect to itself
+    static KickDual variable(double value, int index)
+    {
+        KickDual d(value);
+        d.partials[(size_t)index] = 1.0;
+        return d;
+    }
+
+    double getValue() const { return value; }
+    double getPartial(int index) const { return partials[(size_t)index]; }
+    const std::array<double, NumPartials>& getPartials() const { return partials; }
+
+    KickDual operator-() const { return scaled(-value, -1.0); }
+
+    KickDual& operator+=(const KickDual& other)
+    {
+        value += other.value;
+        for (int i = 0; i < NumPartials; ++i)
+            partials[(size_t)i] += other.partials[(size_t)i];
+        return *this;
+    }
+
+    KickDual& operator-=(const KickDual& other)
+    {
+        value -= other.value;
+        for (int i = 0; i < NumPartials; ++i)
+            partials[(size_t)i] -= other.partials[(size_t)i];
+        return *this;
+    }
+
+    KickDual& operator*=(const KickDual& other)
+    {
+        for (int i = 0; i < NumPartials; ++i)
+            partials[(size_t)i] = partials[(size_t)i] * other.value + value * other.partials[(size_t)i];
+        value *= other.value;
+        return *this;
+    }
+
+    KickDual& operator/=(const KickDual& other)
+    {
+        const double inverse = 1.0 / other.value;
+        const double quotient = value * inverse;
+        for (int i = 0; i < NumPartials; ++i)
+            partials[(size_t)i] = (partials[(size_t)i] - quotient * other.partials[(size_t)i]) * inverse;
+        value = quotient;
+        return *this;
+    }
+
+    KickDual& operator+=(double constant) { value += constant; return *this; }
+    KickDual& operator-=(double constant) { value -= constant; return *this; }
+    KickDual& operator*=(double constant) { *this = scaled(value * constant, constant); return *this; }
+    KickDual& operator/=(double constant) { return *this *= 1.0 / constant; }
+
+    friend KickDual operator+(KickDual a, const KickDual& b) { return a += b; }
+    friend KickDual operator-(KickDual a, const KickDual& b) { return a -= b; }
+    friend KickDual operator*(KickDual a, const KickDual& b) { return a *= b; }
+    friend KickDual operator/(KickDual a, const KickDual& b) { return a /= b; }
+    friend KickDual operator+(KickDual a, double b) { return a += b; }
+    friend KickDual operator-(KickDual a, double b) { return a -= b; }
+    friend KickDual operator*(KickDual a, double b) { return a *= b; }
+    friend KickDual operator/(KickDual a, double b) { return a /= b; }
+    friend KickDual operator+(double a, KickDual b) { return b += a; }
+    friend KickDual operator-(double a, const KickDual& b) { return -b + a; }
+    friend KickDual operator*(double a, KickDual b) { return b *= a; }
+    friend KickDual operator/(double a, const KickDual& b) { return KickDual(a) /= b; }
+
+    friend bool operator<(const KickDual& a, const KickDual& b) { return a.value < b.value; }
+    friend bool operator>(const KickDual& a, const KickDual& b) { return a.value > b.value; }
+    friend bool operator<=(const KickDual& a, const KickDual& b) { return a.value <= b.value; }
+    friend bool operator>=(const KickDual& a, const KickDual& b) { return a.value >= b.value; }
+    friend bool operator==(const KickDual& a, const KickDual& b) { return a.value == b.value; }
+    friend bool operator!=(const KickDual& a, const KickDual& b) { return a.value != b.value; }
+
+    // f(x) with f'(x) = slope: the chain rule for every function below
+    KickDual scaled(double newValue, double slope) const
+    {
+        KickDual d(newValue);
+        for (int i = 0; i < NumPartials; ++i)
+            d.partials[(size_t)i] = slope * partials[(size_t)i];
+        return d;
+    }
+
+    friend KickDual exp(const KickDual& x) { const double e = std::exp(x.value); return x.scaled(e, e); }
+    friend KickDual log(const KickDual& x) { return x.scaled(std::log(x.value), 1.0 / x.value); }
+    friend KickDual log10(const KickDual& x) { return x.scaled(std::log10(x.value), 1.0 / (x.value * 2.302585092994046)); }
+    friend KickDual sqrt(const KickDual& x) { const double r = std::sqrt(x.value); return x.scaled(r, r > 0.0 ? 0.5 / r : 0.0); }
+    friend KickDual sin(const KickDual& x) { return x.scaled(std::sin(x.value), std::cos(x.value)); }
+    friend KickDual cos(const KickDual& x) { return x.scaled(std::cos(x.value), -std::sin(x.value)); }
+    friend KickDual tanh(const KickDual& x) { const double t = std::tanh(x.value); return x.scaled(t, 1.0 - t * t); }
+    friend KickDual abs(const KickDual& x) { return x.scaled(std::abs(x.value), x.value < 0.0 ? -1.0 : 1.0); }
+    friend KickDual pow(const KickDual& x, double p)
+    {
+        const double r = std::pow(x.value, p);
+        return x.scaled(r, p * std::pow(x.value, p - 1.0));
+    }
+
+private:
+    double value = 0.0;
+    std::array<double, NumPartials> partials{};
+};
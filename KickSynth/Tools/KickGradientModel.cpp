@@ -0,0 +1,270 @@
+#include "KickGradientModel.h"
+#include "KickRenderEngine.h"
+#include "../Source/DSP/KickBiquad.h"
+#include "../Source/DSP/KickDistortion.h"
+#include "../Source/DSP/KickLimiter.h"
+#include "../Source/DSP/KickVoice.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr double ln10 = 2.302585092994046;
+
+    using Value = KickGradientModel::Value;
+
+    Value gainToDecibels(const Value& gain)
+    {
+        // Same floor as juce::Decibels::gainToDecibels(gain, -120)
+        if (gain.getValue() <= std::pow(10.0, -120.0 / 20.0))
+            return Value(-120.0);
+        return 20.0 * log10(gain);
+    }
+}
+
+KickGradientModel::KickGradientModel(double rate)
+    : sampleRate(rate),
+      bodyDivider(KickVoice::getBodyDividerForSampleRate(rate)),
+      upsamplerKernels(KickVoice::getUpsamplerKernels(*sharedResources, bodyDivider))
+{
+}
+
+std::array<KickGradientModel::Value, KickGradientModel::numParameters> KickGradientModel::makeInputs(const KickParams& params)
+{
+    std::array<Value, numParameters> inputs;
+    for (int j = 0; j < numParameters; ++j)
+        inputs[(size_t)j] = Value::variable(params.get(parameters[(size_t)j]), j);
+    return inputs;
+}
+
+const std::vector<KickGradientModel::Value>& KickGradientModel::render(const KickParams& params)
+{
+    const auto inputs = makeInputs(params);
+
+    const Value& pitchStartHz = inputs[0];
+    const Value& pitchEndHz = inputs[1];
+    const Value& pitchTauMs = inputs[2];
+    const Value& attackMs = inputs[3];
+    const Value& t12Ms = inputs[4];
+    const Value& t24Ms = inputs[5];
+    const Value& tailMs = inputs[6];
+    const Value& bodyLevel = inputs[7];
+    const Value& clickLevel = inputs[8];
+    const Value& clickDecayMs = inputs[9];
+    const Value& drive = inputs[10];
+    const Value& asymmetry = inputs[11];
+    const Value& outputGainDb = inputs[12];
+
+    const int numSamples = KickRenderEngine::getRenderLength(params, sampleRate);
+    output.assign((size_t)numSamples, Value());
+
+    // Voice (note 60, velocity 1), through the plugin's own render kernels
+    KickVoice::Parameters<Value> voiceParameters;
+    voiceParameters.bodyLevel = bodyLevel;
+    voiceParameters.clickLevel = clickLevel;
+    voiceParameters.pitchStartHz = pitchStartHz;
+    voiceParameters.pitchEndHz = pitchEndHz;
+    voiceParameters.pitchTauMs = pitchTauMs;
+    voiceParameters.attackMs = attackMs;
+    voiceParameters.t12Ms = t12Ms;
+    voiceParameters.t24Ms = t24Ms;
+    voiceParameters.tailMsToMinus60Db = tailMs;
+    voiceParameters.keyTrackingSemitones = params.keyTracking;
+    voiceParameters.retriggerMode = params.retriggerMode;
+
+    const Value velocityScale(KickVoice::getVelocityScale(1.0f, params.velocitySensitivity));
+    auto controls = KickVoice::makeControls(voiceParameters, 60, velocityScale, sampleRate);
+
+    // Click burst: the voice's noise, enveloped on duals
+    const int clickLength = KickVoice::getClickBurstLength(sampleRate, params.clickDecayMs);
+    clickNoise.resize((size_t)clickLength);
+    clickBurst.resize((size_t)clickLength);
+    if (clickLength > 0)
+    {
+        KickVoice::renderClickNoise(clickNoise.data(), clickLength, sampleRate, params.clickHPFHz,
+                                     (uint64_t)(uint32_t)params.noiseSeed);
+        std::copy(clickNoise.begin(), clickNoise.end(), clickBurst.begin());
+        KickVoice::applyClickDecay(clickBurst.data(), clickLength, sampleRate, clickDecayMs);
+    }
+    controls.clickBurst = clickBurst.data();
+    controls.clickBurstLength = clickLength;
+
+    KickVoice::Synthesis<Value> synthesis;
+    synthesis.setBodyRate(sampleRate, bodyDivider, upsamplerKernels.get());
+    synthesis.noteOn(voiceParameters.pitchStartHz);
+    const auto kernel = KickVoice::getRenderKernel<Value>(params.bodyOscType, params.keyTracking != 0.0f,
+                                                          params.attackMs != 0.0f, bodyDivider > 1);
+    (synthesis.*kernel)(controls, output.data(), numSamples);
+
+    // Chain after the voice
+    using Coefficients = KickBiquad<Value>::Coefficients;
+    KickBiquad<Value> outputHPF(Coefficients::makeHighPass(sampleRate, Coefficients::limitCutoff(sampleRate, params.outputHPFHz)));
+    const bool distortionBypassed = params.drive <= 0.000001f;
+    const Value driveAmount = KickDistortion::driveGain(drive);
+    const Value outputGain = exp(outputGainDb * (ln10 / 20.0));
+    const bool softClipped = params.limiterEnabled && params.limiterMode == 0;
+
+    for (auto& sample : output)
+    {
+        sample = outputHPF.processSample(sample);
+
+        if (!distortionBypassed)
+        {
+            const Value driven = sample * driveAmount;
+            switch (params.distortionType)
+            {
+                case 0:  sample = KickDistortion::transfer<0>(driven, asymmetry); break;
+                case 1:  sample = KickDistortion::transfer<1>(driven, asymmetry); break;
+                default: sample = KickDistortion::transfer<2>(driven, asymmetry); break;
+            }
+        }
+
+        sample *= outputGain;
+        if (softClipped)
+            sample = KickLimiter::softClip(sample);
+    }
+
+    return output;
+}
+
+KickGradientModel::Value KickGradientModel::bandRms(double lowHz, double highHz) const
+{
+    // Same filters as KickAnalyzer::bandRms
+    const bool useHp = lowHz > 0.0;
+    const bool useLp = highHz > 0.0 && highHz < (sampleRate * 0.5);
+
+    KickBiquad<Value> hp, lp;
+    if (useHp)
+        hp.setCoefficients(KickBiquad<Value>::Coefficients::makeHighPass(sampleRate, lowHz));
+    if (useLp)
+        lp.setCoefficients(KickBiquad<Value>::Coefficients::makeLowPass(sampleRate, highHz));
+
+    Value sum(0.0);
+    for (const auto& sample : output)
+    {
+        Value y = sample;
+        if (useHp)
+            y = hp.processSample(y);
+        if (useLp)
+            y = lp.processSample(y);
+        sum += y * y;
+    }
+    return sqrt(sum / (double)output.size());
+}
+
+KickGradientModel::Result KickGradientModel::evaluate(const KickParams& rawParams)
+{
+    const KickParams params = rawParams.clamped();
+    const auto inputs = makeInputs(params);
+    render(params);
+
+    const int numSamples = (int)output.size();
+    const double msPerSample = 1000.0 / sampleRate;
+
+    // Peak, RMS and crest (the render starts at the note-on, so the analyser's onset is sample 0)
+    int peakIndex = 0;
+    for (int i = 1; i < numSamples; ++i)
+        if (std::abs(output[(size_t)i].getValue()) > std::abs(output[(size_t)peakIndex].getValue()))
+            peakIndex = i;
+    const Value peak = abs(output[(size_t)peakIndex]);
+    const Value peakDb = gainToDecibels(peak);
+
+    const int rmsSamples = std::min((int)std::round(sampleRate * 0.1), numSamples);
+    Value sumSquares(0.0);
+    for (int i = 0; i < rmsSamples; ++i)
+        sumSquares += output[(size_t)i] * output[(size_t)i];
+    const Value rmsDb = gainToDecibels(sqrt(sumSquares / (double)std::max(1, rmsSamples)));
+
+    // The peak position is discrete; with an attack ramp the envelope peaks at attackMs, which is
+    // where its derivative comes from
+    Value attack(peakIndex * msPerSample);
+    if (params.attackMs != 0.0f)
+        attack += inputs[3] - (double)params.attackMs;
+
+    // Threshold crossings of the peak envelope: straight lines between the local maxima of |y|,
+    // crossed where the line between the last maximum above and the first below meets the threshold
+    std::vector<int> peaks { 0 };
+    for (int i = 1; i < numSamples - 1; ++i)
+    {
+        const double v = std::abs(output[(size_t)i].getValue());
+        if (v >= std::abs(output[(size_t)(i - 1)].getValue()) && v > std::abs(output[(size_t)(i + 1)].getValue()))
+            peaks.push_back(i);
+    }
+    if (numSamples > 1)
+        peaks.push_back(numSamples - 1);
+
+    auto crossing = [&](const Value& threshold) -> Value
+    {
+        int previous = -1;
+        for (int index : peaks)
+        {
+            if (index < peakIndex)
+                continue;
+
+            const Value level = abs(output[(size_t)index]);
+            if (level <= threshold)
+            {
+                if (previous < 0)
+                    return Value((double)index);
+                const Value previousLevel = abs(output[(size_t)previous]);
+                const Value fraction = (previousLevel - threshold) / (previousLevel - level);
+                return (double)previous + fraction * (double)(index - previous);
+            }
+            previous = index;
+        }
+        return Value((double)numSamples);
+    };
+
+    const Value t12 = (crossing(peak * std::pow(10.0, -12.0 / 20.0)) - (double)peakIndex) * msPerSample;
+    const Value t24 = (crossing(peak * std::pow(10.0, -24.0 / 20.0)) - (double)peakIndex) * msPerSample;
+    const Value tail = crossing(peak * std::pow(10.0, -60.0 / 20.0)) * msPerSample;
+
+    // Pitch: the tracker takes medians over its windows, which for a monotonic sweep sit at the
+    // middle window, read here at its centre (15 ms high-band windows at the start, 60 ms low-band
+    // windows at the end)
+    const double keyTrackingRatio = params.keyTracking != 0.0f ? std::pow(2.0, params.keyTracking / 12.0) : 1.0;
+    auto pitchAt = [&](double timeMs)
+    {
+        return (inputs[1] + (inputs[0] - inputs[1]) * KickVoice::pitchSweepWeight(Value(timeMs / 1000.0), inputs[2] / 1000.0))
+               * keyTrackingRatio;
+    };
+
+    const double totalMs = numSamples * msPerSample;
+    const double activeMs = juce::jlimit(0.0, totalMs, tail.getValue() > 0.0 ? tail.getValue() : totalMs);
+    const double startCentreMs = 0.5 * std::min(30.0, activeMs) + 7.5;
+    const double endFromMs = activeMs >= 180.0 ? 120.0 : std::max(0.0, activeMs - 30.0);
+    const double endToMs = activeMs >= 180.0 ? 180.0 : activeMs;
+    const double endCentreMs = 0.5 * (endFromMs + endToMs) + 30.0;
+
+    // Band ratios
+    const Value subRms = bandRms(20.0, 60.0);
+    const Value bodyRms = bandRms(60.0, 200.0);
+    const Value clickRms = bandRms(2000.0, std::min(10000.0, sampleRate * 0.45));
+
+    Result result;
+    auto set = [&](double KickMetrics::* metric, const Value& value)
+    {
+        result.metrics.*metric = value.getValue();
+        for (int j = 0; j < numParameters; ++j)
+            result.derivatives[(size_t)j].*metric = value.getPartial(j);
+    };
+
+    set(&KickMetrics::peak_dbfs, peakDb);
+    set(&KickMetrics::true_peak_dbfs, peakDb);
+    set(&KickMetrics::rms_0_100ms_dbfs, rmsDb);
+    set(&KickMetrics::crest_db, peakDb - rmsDb);
+    set(&KickMetrics::attack_ms, attack);
+    set(&KickMetrics::t12_ms, t12);
+    set(&KickMetrics::t24_ms, t24);
+    set(&KickMetrics::tail_ms_to_minus60db, tail);
+    set(&KickMetrics::pitch_start_hz, pitchAt(startCentreMs));
+    set(&KickMetrics::pitch_end_hz, pitchAt(endCentreMs));
+    set(&KickMetrics::pitch_tau_ms, inputs[2]);
+    if (bodyRms.getValue() > 0.0)
+    {
+        set(&KickMetrics::sub_20_60_over_body_60_200, subRms / bodyRms);
+        set(&KickMetrics::click_2k_10k_over_body_60_200, clickRms / bodyRms);
+    }
+
+    return result;
+}
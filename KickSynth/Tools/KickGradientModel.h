@@ -0,0 +1,69 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "KickDual.h"
+#include "KickMetrics.h"
+#include "KickParams.h"
+#include "../Source/DSP/KickVoice.h"
+#include <array>
+#include <memory>
+#include <vector>
+
+/**
+ * KickGradientModel - Differentiable model of the kick render, for gradient-based fitting
+ *
+ * Renders one kick on dual numbers (KickDual), so every output sample carries its derivatives with
+ * respect to the continuous parameters below, through the same templated code the plugin runs:
+ * KickVoice's render kernels (band-limited body at the plugin's body rate, envelopes, click burst),
+ * KickBiquad for the output HPF, KickDistortion's drive and shaper curves and KickLimiter's soft
+ * clip. Parts without a useful derivative are simplified: the shapers run without ADAA, the
+ * true-peak limiter as its output gain, and filter cutoffs, types and modes are held at their values.
+ *
+ * From that render it measures smooth counterparts of the analyser's score metrics (peak envelope
+ * crossings interpolated between peaks, band RMS through the same filters, the pitch sweep read at
+ * the centre of the tracker's windows), so one pass gives the Jacobian of the metrics with respect
+ * to the parameters. The values are estimates; kick_fit takes the metrics themselves from real renders.
+ */
+class KickGradientModel
+{
+public:
+    // Parameters the derivatives are taken with respect to, in derivative order
+    static constexpr std::array<int, 13> parameters = {
+        KickParameterSchema::pitchStartHz, KickParameterSchema::pitchEndHz, KickParameterSchema::pitchTauMs,
+        KickParameterSchema::attackMs, KickParameterSchema::t12Ms, KickParameterSchema::t24Ms,
+        KickParameterSchema::tailMsToMinus60Db, KickParameterSchema::bodyLevel, KickParameterSchema::clickLevel,
+        KickParameterSchema::clickDecayMs, KickParameterSchema::drive, KickParameterSchema::asymmetry,
+        KickParameterSchema::outputGainDb
+    };
+    static constexpr int numParameters = (int)parameters.size();
+
+    using Value = KickDual<numParameters>;
+
+    struct Result
+    {
+        KickMetrics metrics;                               // model estimate of every scored metric
+        std::array<KickMetrics, numParameters> derivatives; // d metric / d parameters[j], per metric
+    };
+
+    explicit KickGradientModel(double sampleRate);
+
+    // Renders params (note 60, velocity 1) and differentiates the metrics
+    Result evaluate(const KickParams& params);
+
+    // The render evaluate() measures, for clamped params (kick_bench --model-check compares it
+    // with KickRenderEngine)
+    const std::vector<Value>& render(const KickParams& params);
+
+private:
+    static std::array<Value, numParameters> makeInputs(const KickParams& params);
+    Value bandRms(double lowHz, double highHz) const;
+
+    double sampleRate = 48000.0;
+    int bodyDivider = 1;
+    juce::SharedResourcePointer<SharedResources> sharedResources;
+    std::shared_ptr<const KickVoice::UpsamplerKernels> upsamplerKernels;
+
+    std::vector<Value> output;
+    std::vector<float> clickNoise;
+    std::vector<Value> clickBurst;
+};
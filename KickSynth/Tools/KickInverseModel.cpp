@@ -0,0 +1,182 @@
+#include "KickInverseModel.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace
+{
+    constexpr int fileMagic = 0x4d4b494b; // "KIKM"
+    constexpr int fileFormatVersion = 2; // 2: pitch metrics from the decimated analyser
+
+    // Every KickMetrics field, in file order
+    const std::array<double KickMetrics::*, 13> storedMetrics = {
+        &KickMetrics::peak_dbfs, &KickMetrics::true_peak_dbfs, &KickMetrics::rms_0_100ms_dbfs,
+        &KickMetrics::crest_db, &KickMetrics::attack_ms, &KickMetrics::t12_ms, &KickMetrics::t24_ms,
+        &KickMetrics::tail_ms_to_minus60db, &KickMetrics::pitch_start_hz, &KickMetrics::pitch_end_hz,
+        &KickMetrics::pitch_tau_ms, &KickMetrics::sub_20_60_over_body_60_200,
+        &KickMetrics::click_2k_10k_over_body_60_200
+    };
+    static_assert(sizeof(KickMetrics) == sizeof(double) * 13, "storedMetrics must list every KickMetrics field");
+}
+
+void KickInverseModel::add(const KickParams& params, const KickMetrics& metrics)
+{
+    entries.push_back({ params, metrics });
+}
+
+KickParams KickInverseModel::drawParams(std::mt19937& rng, int antialiasing)
+{
+    std::uniform_real_distribution<double> dist01(0.0, 1.0);
+
+    KickParams params;
+    for (int index = 0; index < KickParameterSchema::numParameters; ++index)
+    {
+        const auto& spec = KickParameterSchema::specs[(size_t)index];
+        if (!spec.isFitted())
+            continue;
+
+        const double u = dist01(rng);
+        if (spec.minValue > 0.0f && spec.maxValue >= 10.0f * spec.minValue)
+            params.set(index, (float)(spec.minValue * std::pow((double)spec.maxValue / spec.minValue, u)));
+        else
+            params.set(index, (float)(spec.minValue + u * (spec.maxValue - spec.minValue)));
+    }
+
+    for (int index : { (int)KickParameterSchema::bodyOscType, (int)KickParameterSchema::distortionType })
+    {
+        const int numChoices = (int)KickParameterSchema::specs[(size_t)index].maxValue + 1;
+        params.set(index, (float)std::min(numChoices - 1, (int)(dist01(rng) * numChoices)));
+    }
+
+    params.distortionAntialiasing = antialiasing;
+    return params.clamped();
+}
+
+std::vector<KickInverseModel::Neighbour> KickInverseModel::findNearest(const KickMetrics& target, int k) const
+{
+    std::vector<Neighbour> neighbours;
+    neighbours.reserve(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i)
+        neighbours.push_back({ (int)i, computeScore(target, entries[i].metrics).score });
+
+    const size_t count = (size_t)juce::jlimit(0, (int)neighbours.size(), k);
+    std::partial_sort(neighbours.begin(), neighbours.begin() + (std::ptrdiff_t)count, neighbours.end(),
+                      [](const Neighbour& a, const Neighbour& b)
+                      {
+                          return a.distance < b.distance || (a.distance == b.distance && a.index < b.index);
+                      });
+    neighbours.resize(count);
+    return neighbours;
+}
+
+KickParams KickInverseModel::predict(const KickMetrics& target, int k) const
+{
+    const auto neighbours = findNearest(target, k);
+    if (neighbours.empty())
+        return {};
+
+    const KickParams& nearest = entries[(size_t)neighbours.front().index].params;
+    KickParams result = nearest;
+
+    // Blend in schema-normalised units; an exact match (distance 0) keeps its own values
+    for (int index = 0; index < KickParameterSchema::numParameters; ++index)
+    {
+        const auto& spec = KickParameterSchema::specs[(size_t)index];
+        if (!spec.isFitted())
+            continue;
+
+        const double range = (double)spec.maxValue - (double)spec.minValue;
+        double sum = 0.0;
+        double weightSum = 0.0;
+        for (const auto& neighbour : neighbours)
+        {
+            const KickParams& params = entries[(size_t)neighbour.index].params;
+            if (params.bodyOscType != nearest.bodyOscType || params.distortionType != nearest.distortionType)
+                continue;
+
+            const double weight = 1.0 / (neighbour.distance + 1.0e-3);
+            sum += weight * (params.get(index) - spec.minValue) / range;
+            weightSum += weight;
+        }
+
+        result.set(index, (float)(spec.minValue + range * sum / weightSum));
+    }
+
+    return result.clamped();
+}
+
+std::vector<KickParams> KickInverseModel::suggest(const KickMetrics& target, int count) const
+{
+    std::vector<KickParams> suggestions;
+    if (count <= 0 || entries.empty())
+        return suggestions;
+
+    suggestions.push_back(predict(target));
+    for (const auto& neighbour : findNearest(target, count - 1))
+        suggestions.push_back(entries[(size_t)neighbour.index].params);
+    return suggestions;
+}
+
+void KickInverseModel::write(juce::MemoryOutputStream& out) const
+{
+    out.writeInt(fileMagic);
+    out.writeInt(fileFormatVersion);
+    out.writeDouble(sampleRate);
+    out.writeString(KickParams::getSchemaSignature());
+    out.writeInt((int)entries.size());
+
+    for (const auto& entry : entries)
+    {
+        for (int index = 0; index < KickParameterSchema::numParameters; ++index)
+            out.writeFloat(entry.params.get(index));
+        out.writeInt(entry.params.noiseSeed);
+        for (auto metric : storedMetrics)
+            out.writeFloat((float)(entry.metrics.*metric));
+    }
+}
+
+bool KickInverseModel::read(juce::MemoryInputStream& in)
+{
+    if (in.readInt() != fileMagic || in.readInt() != fileFormatVersion)
+        return false;
+
+    const double rate = in.readDouble();
+    if (in.readString() != KickParams::getSchemaSignature())
+        return false;
+
+    const int numEntries = in.readInt();
+    const int64_t entryBytes = (int64_t)(KickParameterSchema::numParameters + 1 + (int)storedMetrics.size()) * 4;
+    if (numEntries < 0 || in.getNumBytesRemaining() != (int64_t)numEntries * entryBytes)
+        return false;
+
+    std::vector<Entry> loaded((size_t)numEntries);
+    for (auto& entry : loaded)
+    {
+        for (int index = 0; index < KickParameterSchema::numParameters; ++index)
+            entry.params.set(index, in.readFloat());
+        entry.params.noiseSeed = in.readInt();
+        for (auto metric : storedMetrics)
+            entry.metrics.*metric = (double)in.readFloat();
+    }
+
+    sampleRate = rate;
+    entries = std::move(loaded);
+    return true;
+}
+
+bool KickInverseModel::save(const juce::File& file) const
+{
+    juce::MemoryOutputStream out;
+    write(out);
+    return file.replaceWithData(out.getData(), out.getDataSize());
+}
+
+bool KickInverseModel::load(const juce::File& file)
+{
+    juce::MemoryBlock data;
+    if (!file.existsAsFile() || !file.loadFileAsData(data))
+        return false;
+
+    juce::MemoryInputStream in(data.getData(), data.getSize(), false);
+    return read(in);
+}
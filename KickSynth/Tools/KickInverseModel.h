@@ -0,0 +1,75 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "KickMetrics.h"
+#include "KickParams.h"
+#include <random>
+#include <vector>
+
+/**
+ * KickInverseModel - Learned map from target metrics to parameters, for warm-starting fits
+ *
+ * Holds a sample of rendered kicks (kick_train) as parameter sets with their analysed metrics and
+ * answers by k nearest neighbours: the distance from a target to an entry is computeScore, the
+ * weighted sum of per-metric errors each divided by its score scale, so the nearest entries are the
+ * sampled kicks that would score best against the target. predict blends the fitted parameters of
+ * the neighbours that share the nearest one's oscillator and distortion types, weighted by inverse
+ * distance; everything else comes from the nearest entry.
+ *
+ * Models are stored as a compact binary file (parameters and metrics as 32-bit floats) together
+ * with the sample rate they were rendered at and the parameter schema; load refuses files written
+ * for another schema.
+ */
+class KickInverseModel
+{
+public:
+    struct Entry
+    {
+        KickParams params;
+        KickMetrics metrics;
+    };
+
+    struct Neighbour
+    {
+        int index = 0;
+        double distance = 0.0; // computeScore(target, entry metrics)
+    };
+
+    static constexpr int defaultNeighbours = 8;
+
+    // A random parameter set for training: every fitted parameter over its schema range,
+    // log-uniformly when the range starts above zero and spans a decade or more (times,
+    // frequencies), uniformly otherwise; the oscillator and distortion types uniformly over their
+    // choices
+    static KickParams drawParams(std::mt19937& rng, int antialiasing);
+
+    void setSampleRate(double rate) { sampleRate = rate; }
+    double getSampleRate() const { return sampleRate; }
+
+    void add(const KickParams& params, const KickMetrics& metrics);
+    int size() const { return (int)entries.size(); }
+    bool isEmpty() const { return entries.empty(); }
+    const Entry& getEntry(int index) const { return entries[(size_t)index]; }
+
+    // Up to k entries, nearest first
+    std::vector<Neighbour> findNearest(const KickMetrics& target, int k) const;
+
+    // Parameters blended from the k nearest entries (defaults if the model is empty)
+    KickParams predict(const KickMetrics& target, int k = defaultNeighbours) const;
+
+    // Starting points for a fit: the prediction, then the parameters of the nearest entries
+    std::vector<KickParams> suggest(const KickMetrics& target, int count) const;
+
+    bool save(const juce::File& file) const;
+
+    // Replaces the entries with a model file's; returns false if it is missing, damaged or was
+    // written for another parameter schema
+    bool load(const juce::File& file);
+
+    void write(juce::MemoryOutputStream& out) const;
+    bool read(juce::MemoryInputStream& in);
+
+private:
+    double sampleRate = 48000.0;
+    std::vector<Entry> entries;
+};
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "../Source/DSP/KickSampleTraits.h"
+#include <array>
+#include <cmath>
+
+/**
+ * KickLanes - N values side by side as one sample type, for rendering N kicks in one pass
+ *
+ * Arithmetic, comparisons and math functions apply lane by lane with the scalar operation, so each
+ * lane computes what the scalar code computes for it, bit for bit (the lane loops are plain loops the
+ * compiler may vectorise; on targets where it contracts a multiply and an add into one instruction
+ * the lanes can differ from the scalar code in the last bit). Comparisons yield a KickLaneMask, and
+ * KickSampleTraits below turn a branch on one into a per-lane select.
+ */
+template <int N>
+class KickLaneMask
+{
+public:
+    KickLaneMask() = default;
+    KickLaneMask(bool value) { lanes.fill(value); } // implicit: a condition for every lane
+
+    bool& operator[](int lane) { return lanes[(size_t)lane]; }
+    bool operator[](int lane) const { return lanes[(size_t)lane]; }
+
+    bool any() const
+    {
+        for (bool lane : lanes)
+            if (lane)
+                return true;
+        return false;
+    }
+
+    bool all() const
+    {
+        for (bool lane : lanes)
+            if (!lane)
+                return false;
+        return true;
+    }
+
+    friend KickLaneMask operator&&(const KickLaneMask& a, const KickLaneMask& b)
+    {
+        KickLaneMask result;
+        for (int i = 0; i < N; ++i)
+            result[i] = a[i] && b[i];
+        return result;
+    }
+
+    friend KickLaneMask operator||(const KickLaneMask& a, const KickLaneMask& b)
+    {
+        KickLaneMask result;
+        for (int i = 0; i < N; ++i)
+            result[i] = a[i] || b[i];
+        return result;
+    }
+
+    friend KickLaneMask operator!(const KickLaneMask& a)
+    {
+        KickLaneMask result;
+        for (int i = 0; i < N; ++i)
+            result[i] = !a[i];
+        return result;
+    }
+
+private:
+    std::array<bool, N> lanes {};
+};
+
+template <typename T, int N>
+class KickLanes
+{
+public:
+    using Mask = KickLaneMask<N>;
+    static constexpr int numLanes = N;
+
+    KickLanes() = default;
+    KickLanes(T value) { lanes.fill(value); } // implicit: constants mix freely with lanes
+
+    // Lane-by-lane conversion, as static_cast on each lane
+    template <typename U>
+    explicit KickLanes(const KickLanes<U, N>& other)
+    {
+        for (int i = 0; i < N; ++i)
+            lanes[(size_t)i] = static_cast<T>(other[i]);
+    }
+
+    T& operator[](int lane) { return lanes[(size_t)lane]; }
+    const T& operator[](int lane) const { return lanes[(size_t)lane]; }
+
+    // ifTrue where the mask is set, ifFalse elsewhere
+    static KickLanes select(const Mask& mask, const KickLanes& ifTrue, const KickLanes& ifFalse)
+    {
+        KickLanes result;
+        for (int i = 0; i < N; ++i)
+            result[i] = mask[i] ? ifTrue[i] : ifFalse[i];
+        return result;
+    }
+
+    KickLanes operator-() const { return map([](T x) { return -x; }); }
+
+    KickLanes& operator+=(const KickLanes& other) { for (int i = 0; i < N; ++i) lanes[(size_t)i] += other[i]; return *this; }
+    KickLanes& operator-=(const KickLanes& other) { for (int i = 0; i < N; ++i) lanes[(size_t)i] -= other[i]; return *this; }
+    KickLanes& operator*=(const KickLanes& other) { for (int i = 0; i < N; ++i) lanes[(size_t)i] *= other[i]; return *this; }
+    KickLanes& operator/=(const KickLanes& other) { for (int i = 0; i < N; ++i) lanes[(size_t)i] /= other[i]; return *this; }
+
+    friend KickLanes operator+(KickLanes a, const KickLanes& b) { return a += b; }
+    friend KickLanes operator-(KickLanes a, const KickLanes& b) { return a -= b; }
+    friend KickLanes operator*(KickLanes a, const KickLanes& b) { return a *= b; }
+    friend KickLanes operator/(KickLanes a, const KickLanes& b) { return a /= b; }
+
+    friend Mask operator<(const KickLanes& a, const KickLanes& b) { return compare(a, b, [](T x, T y) { return x < y; }); }
+    friend Mask operator>(const KickLanes& a, const KickLanes& b) { return compare(a, b, [](T x, T y) { return x > y; }); }
+    friend Mask operator<=(const KickLanes& a, const KickLanes& b) { return compare(a, b, [](T x, T y) { return x <= y; }); }
+    friend Mask operator>=(const KickLanes& a, const KickLanes& b) { return compare(a, b, [](T x, T y) { return x >= y; }); }
+
+    // The scalar calls, one per lane
+    friend KickLanes exp(const KickLanes& x) { return x.map([](T v) { return std::exp(v); }); }
+    friend KickLanes sin(const KickLanes& x) { return x.map([](T v) { return std::sin(v); }); }
+
+private:
+    std::array<T, N> lanes {};
+
+    template <typename Function>
+    KickLanes map(Function&& function) const
+    {
+        KickLanes result;
+        for (int i = 0; i < N; ++i)
+            result[i] = function(lanes[(size_t)i]);
+        return result;
+    }
+
+    template <typename Function>
+    static Mask compare(const KickLanes& a, const KickLanes& b, Function&& function)
+    {
+        Mask result;
+        for (int i = 0; i < N; ++i)
+            result[i] = function(a[i], b[i]);
+        return result;
+    }
+};
+
+// Time and the amplitude envelope run in lanes of the scalar's wide type. A branch every lane takes
+// the same way calls that side only (the usual case: the oscillator residuals, the attack ramp);
+// otherwise both sides are evaluated and selected per lane.
+template <typename T, int N>
+struct KickSampleTraits<KickLanes<T, N>>
+{
+    using Wide = KickLanes<typename KickSampleTraits<T>::Wide, N>;
+    using Mask = KickLaneMask<N>;
+
+    static bool anyOf(const Mask& mask) { return mask.any(); }
+
+    template <typename IfTrue, typename IfFalse>
+    static auto choose(const Mask& condition, IfTrue&& ifTrue, IfFalse&& ifFalse)
+    {
+        using Result = decltype(ifTrue());
+        if (condition.all())
+            return Result(ifTrue());
+        if (!condition.any())
+            return Result(ifFalse());
+        return Result::select(condition, ifTrue(), Result(ifFalse()));
+    }
+};
@@ -1,9 +1,81 @@
 #include "KickMetrics.h"
+#include "../Source/DSP/KickBiquad.h"
 
 #include <algorithm>
 #include <cmath>
 #include <numeric>
 
+namespace
+{
+    // Odd taps (offsets 1, 3, ..., 9 either side of the centre) of a 19-tap half-band lowpass,
+    // a Kaiser-windowed sinc (beta 6). The centre tap is 0.5 and the other even taps are zero.
+    // Flat within 0.01 dB up to 0.1 fs and at least 62 dB down from 0.4 fs, so every stage of a
+    // 2:1 cascade keeps the band below a fifth of the final rate free of aliases.
+    constexpr std::array<float, 5> halfBandTaps { 3.079123161e-01f, -7.770894473e-02f, 2.555474339e-02f,
+                                                  -6.284506552e-03f, 5.263918436e-04f };
+    constexpr int halfBandReach = 2 * (int)halfBandTaps.size() - 1;
+
+    // One 2:1 stage: output[m] is the filtered input at 2m (zero phase, so the decimated signal keeps
+    // the timing of plain sample skipping). Only the kept outputs are computed, and the input is
+    // taken as zero outside the buffer.
+    void decimateByTwo(const float* input, int numInput, std::vector<float>& output)
+    {
+        const int numOutput = (numInput + 1) / 2;
+        output.resize((size_t)numOutput);
+
+        auto at = [&](int i) { return (i >= 0 && i < numInput) ? input[i] : 0.0f; };
+        for (int m = 0; m < numOutput; ++m)
+        {
+            const int centre = 2 * m;
+            float sum = 0.5f * input[centre];
+            if (centre >= halfBandReach && centre + halfBandReach < numInput)
+            {
+                for (size_t k = 0; k < halfBandTaps.size(); ++k)
+                {
+                    const int offset = 2 * (int)k + 1;
+                    sum += halfBandTaps[k] * (input[centre - offset] + input[centre + offset]);
+                }
+            }
+            else
+            {
+                for (size_t k = 0; k < halfBandTaps.size(); ++k)
+                {
+                    const int offset = 2 * (int)k + 1;
+                    sum += halfBandTaps[k] * (at(centre - offset) + at(centre + offset));
+                }
+            }
+            output[(size_t)m] = sum;
+        }
+    }
+
+    // Decimates by factor (a power of two) through a cascade of 2:1 stages into output
+    void decimate(const float* input, int numInput, int factor, std::vector<float>& output,
+                  std::vector<float>& scratch)
+    {
+        int numStages = 0;
+        while ((1 << numStages) < factor)
+            ++numStages;
+
+        if (numStages == 0)
+        {
+            output.assign(input, input + numInput);
+            return;
+        }
+
+        // Alternate between the output and the scratch buffer so the last stage lands in the output
+        std::vector<float>* buffers[] = { &output, &scratch };
+        const float* stageInput = input;
+        int numStageInput = numInput;
+        for (int stage = 0; stage < numStages; ++stage)
+        {
+            auto& stageOutput = *buffers[(numStages - 1 - stage) % 2];
+            decimateByTwo(stageInput, numStageInput, stageOutput);
+            stageInput = stageOutput.data();
+            numStageInput = (int)stageOutput.size();
+        }
+    }
+}
+
 juce::String KickMetrics::toJson() const
 {
     auto obj = juce::DynamicObject::Ptr(new juce::DynamicObject());
@@ -60,19 +132,42 @@ KickAnalyzeResult KickAnalyzer::analyzeFile(const juce::File& file)
     return analyzeBuffer(buffer, reader->sampleRate);
 }
 
-KickAnalyzeResult KickAnalyzer::analyzeBuffer(const juce::AudioBuffer<float>& buffer, double sampleRate)
+KickAnalyzeResult KickAnalyzer::analyzeBuffer(const juce::AudioBuffer<float>& buffer, double sampleRate,
+                                              const AbortCheck& shouldAbort, const StageCheck& afterStage)
+{
+    AnalysisWorkspace workspace;
+    return analyzeBuffer(buffer, sampleRate, workspace, shouldAbort, afterStage);
+}
+
+KickAnalyzeResult KickAnalyzer::analyzeBuffer(const juce::AudioBuffer<float>& buffer, double sampleRate,
+                                              AnalysisWorkspace& workspace,
+                                              const AbortCheck& shouldAbort, const StageCheck& afterStage)
 {
     KickAnalyzeResult result;
     result.sample_rate = sampleRate;
 
+    auto aborted = [&]()
+    {
+        if (shouldAbort && shouldAbort())
+            result.aborted = true;
+        return result.aborted;
+    };
+
+    auto completeStage = [&](KickAnalysisStage stage)
+    {
+        result.completedStage = stage;
+        if (afterStage && afterStage(stage, result.metrics))
+            result.aborted = true;
+        return aborted();
+    };
+
     if (buffer.getNumSamples() == 0 || buffer.getNumChannels() == 0)
         return result;
 
-    auto mono = toMono(buffer);
-    const float* samples = mono.getReadPointer(0);
-    int numSamples = mono.getNumSamples();
+    const float* samples = toMono(buffer, workspace);
+    int numSamples = buffer.getNumSamples();
 
-    int onset = findOnsetSample(samples, numSamples, sampleRate);
+    int onset = findOnsetSample(samples, numSamples, sampleRate, workspace);
     onset = juce::jlimit(0, numSamples, onset);
 
     result.onset_sample = onset;
@@ -83,10 +178,10 @@ KickAnalyzeResult KickAnalyzer::analyzeBuffer(const juce::AudioBuffer<float>& bu
     if (trimmedSamples <= 0)
         return result;
 
-    juce::AudioBuffer<float> trimmed(1, trimmedSamples);
-    trimmed.copyFrom(0, 0, mono, 0, onset, trimmedSamples);
-
-    const float* t = trimmed.getReadPointer(0);
+    // The trimmed audio is read in place
+    const float* t = samples + onset;
+    if (aborted())
+        return result;
 
     // Sample peak and true peak (dBFS).
     // Note: peak_dbfs may be > 0 when the input contains inter-sample or explicit sample clipping.
@@ -103,8 +198,6 @@ KickAnalyzeResult KickAnalyzer::analyzeBuffer(const juce::AudioBuffer<float>& bu
     }
 
     result.metrics.peak_dbfs = juce::Decibels::gainToDecibels((float)peak, -120.0f);
-    double truePeak = computeTruePeak(t, trimmedSamples);
-    result.metrics.true_peak_dbfs = juce::Decibels::gainToDecibels((float)truePeak, -120.0f);
 
     // RMS 0-100ms
     int samples100ms = (int)std::round(sampleRate * 0.1);
@@ -117,7 +210,10 @@ KickAnalyzeResult KickAnalyzer::analyzeBuffer(const juce::AudioBuffer<float>& bu
 
     // Envelope timing metrics, measured on a peak-envelope to avoid zero-crossing artifacts.
     // Definition: threshold = peak * 10^(dB/20), where peak is the sample-peak of the trimmed audio.
-    auto envelope = buildPeakEnvelope(t, trimmedSamples);
+    buildPeakEnvelope(t, trimmedSamples, workspace);
+    const auto& envelope = workspace.envelope;
+    if (aborted())
+        return result;
 
     double t12Thresh = peak * std::pow(10.0, -12.0 / 20.0);
     double t24Thresh = peak * std::pow(10.0, -24.0 / 20.0);
@@ -154,6 +250,28 @@ KickAnalyzeResult KickAnalyzer::analyzeBuffer(const juce::AudioBuffer<float>& bu
         }
     }
 
+    if (completeStage(KickAnalysisStage::Envelope))
+        return result;
+
+    // True peak (4x oversampled)
+    double truePeak = computeTruePeak(t, trimmedSamples, workspace);
+    result.metrics.true_peak_dbfs = juce::Decibels::gainToDecibels((float)truePeak, -120.0f);
+
+    // Spectral ratios
+    double subRms = bandRms(t, trimmedSamples, sampleRate, 20.0, 60.0);
+    double bodyRms = bandRms(t, trimmedSamples, sampleRate, 60.0, 200.0);
+    // At reduced rates (kick_fit --screen-sr) the click band ends short of Nyquist instead of at 10 kHz
+    const double clickHighHz = std::min(10000.0, sampleRate * 0.45);
+    double clickRms = bandRms(t, trimmedSamples, sampleRate, 2000.0, clickHighHz);
+    if (bodyRms > 0.0)
+    {
+        result.metrics.sub_20_60_over_body_60_200 = subRms / bodyRms;
+        result.metrics.click_2k_10k_over_body_60_200 = clickRms / bodyRms;
+    }
+
+    if (completeStage(KickAnalysisStage::Spectral))
+        return result;
+
     // Pitch tracking using YIN (band-limited + downsampled to avoid STFT-bin artifacts).
     const double totalMs = (trimmedSamples / sampleRate) * 1000.0;
     const double activeMs = juce::jlimit(0.0, totalMs,
@@ -161,11 +279,6 @@ KickAnalyzeResult KickAnalyzer::analyzeBuffer(const juce::AudioBuffer<float>& bu
                                              ? result.metrics.tail_ms_to_minus60db
                                              : totalMs);
 
-    // Use two band-limited pitch tracks:
-    // - "high": tracks the early, higher-frequency part of a typical kick sweep.
-    // - "low": suppresses upper harmonics (helps avoid octave errors later in the tail).
-    auto pitchBandHigh = bandpass(t, trimmedSamples, sampleRate, 80.0, 300.0);
-    auto pitchBandLow = bandpass(t, trimmedSamples, sampleRate, 20.0, 80.0);
     int dsFactor = 1;
     if (sampleRate >= 40000.0)
         dsFactor = 8;
@@ -174,19 +287,21 @@ KickAnalyzeResult KickAnalyzer::analyzeBuffer(const juce::AudioBuffer<float>& bu
     else
         dsFactor = 2;
 
-    auto downsample = [&](const std::vector<float>& src) -> std::vector<float>
-    {
-        std::vector<float> down;
-        down.reserve(src.size() / (size_t)dsFactor + 1);
-        for (int i = 0; i < (int)src.size(); i += dsFactor)
-            down.push_back(src[(size_t)i]);
-        return down;
-    };
-
-    const auto pitchDownHigh = downsample(pitchBandHigh);
-    const auto pitchDownLow = downsample(pitchBandLow);
     const double pitchSampleRate = sampleRate / (double)dsFactor;
 
+    // Decimate once through a half-band cascade (skipping samples would fold everything above the
+    // new Nyquist into the YIN input), then band-limit at the pitch rate
+    decimate(t, trimmedSamples, dsFactor, workspace.pitchDecimated, workspace.decimatorScratch);
+    const int numPitchSamples = (int)workspace.pitchDecimated.size();
+
+    // Use two band-limited pitch tracks:
+    // - "high": tracks the early, higher-frequency part of a typical kick sweep.
+    // - "low": suppresses upper harmonics (helps avoid octave errors later in the tail).
+    bandpass(workspace.pitchDecimated.data(), numPitchSamples, pitchSampleRate, 80.0, 300.0, workspace.pitchBandHigh);
+    bandpass(workspace.pitchDecimated.data(), numPitchSamples, pitchSampleRate, 20.0, 80.0, workspace.pitchBandLow);
+    if (aborted())
+        return result;
+
     auto analyzePitchTrack = [&](const std::vector<float>& signal,
                                  double windowMs,
                                  double hopMs,
@@ -206,13 +321,11 @@ KickAnalyzeResult KickAnalyzer::analyzeBuffer(const juce::AudioBuffer<float>& bu
         const double windowPeakGate = std::max(1e-7, peakAbs * 0.005); // about -46 dB relative
 
         const int maxStart = (int)signal.size() - windowSamples;
-        outTimesMs.reserve(outTimesMs.size() + (size_t)maxStart / (size_t)hopSamples + 1);
-        outPitchesHz.reserve(outTimesMs.capacity());
 
         for (int start = 0; start <= maxStart; start += hopSamples)
         {
             const double timeMs = (start / pitchSampleRate) * 1000.0; // window start time
-            if (timeMs > activeMs)
+            if (timeMs > activeMs || aborted())
                 break;
 
             double wPeak = 0.0;
@@ -221,7 +334,8 @@ KickAnalyzeResult KickAnalyzer::analyzeBuffer(const juce::AudioBuffer<float>& bu
             if (wPeak < windowPeakGate)
                 continue;
 
-            const double pitch = estimatePitchYin(signal.data() + start, windowSamples, pitchSampleRate, minHz, maxHz);
+            const double pitch = estimatePitchYin(signal.data() + start, windowSamples, pitchSampleRate,
+                                                  minHz, maxHz, workspace);
             if (pitch > 0.0)
             {
                 outTimesMs.push_back(timeMs);
@@ -230,17 +344,26 @@ KickAnalyzeResult KickAnalyzer::analyzeBuffer(const juce::AudioBuffer<float>& bu
         }
     };
 
-    std::vector<double> timesHiMs, pitchesHiHz;
-    std::vector<double> timesLoMs, pitchesLoHz;
-    analyzePitchTrack(pitchDownHigh, 15.0, 3.0, 80.0, 300.0, timesHiMs, pitchesHiHz);
-    analyzePitchTrack(pitchDownLow, 60.0, 10.0, 20.0, 80.0, timesLoMs, pitchesLoHz);
+    auto& timesHiMs = workspace.timesHiMs;
+    auto& pitchesHiHz = workspace.pitchesHiHz;
+    auto& timesLoMs = workspace.timesLoMs;
+    auto& pitchesLoHz = workspace.pitchesLoHz;
+    timesHiMs.clear();
+    pitchesHiHz.clear();
+    timesLoMs.clear();
+    pitchesLoHz.clear();
+    analyzePitchTrack(workspace.pitchBandHigh, 15.0, 3.0, 80.0, 300.0, timesHiMs, pitchesHiHz);
+    analyzePitchTrack(workspace.pitchBandLow, 60.0, 10.0, 20.0, 80.0, timesLoMs, pitchesLoHz);
+    if (aborted())
+        return result;
 
     auto pitchMedian = [&](const std::vector<double>& times,
                            const std::vector<double>& pitches,
                            double fromMs,
                            double toMs) -> double
     {
-        std::vector<double> values;
+        auto& values = workspace.medianValues;
+        values.clear();
         for (size_t i = 0; i < times.size(); ++i)
         {
             if (times[i] >= fromMs && times[i] <= toMs)
@@ -269,14 +392,9 @@ KickAnalyzeResult KickAnalyzer::analyzeBuffer(const juce::AudioBuffer<float>& bu
     if (result.metrics.pitch_end_hz <= 0.0)
         result.metrics.pitch_end_hz = result.metrics.pitch_start_hz;
 
-    struct FitPoint
-    {
-        double timeMs = 0.0;
-        double hz = 0.0;
-    };
-
-    std::vector<FitPoint> fitPoints;
-    fitPoints.reserve(timesHiMs.size() + timesLoMs.size());
+    using FitPoint = AnalysisWorkspace::PitchPoint;
+    auto& fitPoints = workspace.fitPoints;
+    fitPoints.clear();
     for (size_t i = 0; i < timesHiMs.size(); ++i)
         fitPoints.push_back({ timesHiMs[i], pitchesHiHz[i] });
     for (size_t i = 0; i < timesLoMs.size(); ++i)
@@ -286,10 +404,10 @@ KickAnalyzeResult KickAnalyzer::analyzeBuffer(const juce::AudioBuffer<float>& bu
         return a.timeMs < b.timeMs;
     });
 
-    std::vector<double> timesFitMs;
-    std::vector<double> pitchesFitHz;
-    timesFitMs.reserve(fitPoints.size());
-    pitchesFitHz.reserve(fitPoints.size());
+    auto& timesFitMs = workspace.timesFitMs;
+    auto& pitchesFitHz = workspace.pitchesFitHz;
+    timesFitMs.clear();
+    pitchesFitHz.clear();
     for (const auto& p : fitPoints)
     {
         if (p.timeMs <= activeMs && p.hz > 0.0)
@@ -301,45 +419,38 @@ KickAnalyzeResult KickAnalyzer::analyzeBuffer(const juce::AudioBuffer<float>& bu
 
     result.metrics.pitch_tau_ms = estimatePitchTau(timesFitMs, pitchesFitHz,
                                                    result.metrics.pitch_start_hz,
-                                                   result.metrics.pitch_end_hz);
-
-    // Spectral ratios
-    double subRms = bandRms(t, trimmedSamples, sampleRate, 20.0, 60.0);
-    double bodyRms = bandRms(t, trimmedSamples, sampleRate, 60.0, 200.0);
-    double clickRms = bandRms(t, trimmedSamples, sampleRate, 2000.0, 10000.0);
-    if (bodyRms > 0.0)
-    {
-        result.metrics.sub_20_60_over_body_60_200 = subRms / bodyRms;
-        result.metrics.click_2k_10k_over_body_60_200 = clickRms / bodyRms;
-    }
+                                                   result.metrics.pitch_end_hz, workspace);
+    result.completedStage = KickAnalysisStage::Pitch;
 
     return result;
 }
 
-juce::AudioBuffer<float> KickAnalyzer::toMono(const juce::AudioBuffer<float>& buffer)
+const float* KickAnalyzer::toMono(const juce::AudioBuffer<float>& buffer, AnalysisWorkspace& workspace)
 {
-    juce::AudioBuffer<float> mono(1, buffer.getNumSamples());
+    // A mono buffer is analysed in place
     if (buffer.getNumChannels() == 1)
-    {
-        mono.copyFrom(0, 0, buffer, 0, 0, buffer.getNumSamples());
-    }
-    else
-    {
-        mono.clear();
-        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
-            mono.addFrom(0, 0, buffer, ch, 0, buffer.getNumSamples(), 1.0f / buffer.getNumChannels());
-    }
-    return mono;
+        return buffer.getReadPointer(0);
+
+    const int numSamples = buffer.getNumSamples();
+    const float gain = 1.0f / buffer.getNumChannels();
+    auto& mono = workspace.mono;
+    mono.resize((size_t)numSamples);
+    juce::FloatVectorOperations::copyWithMultiply(mono.data(), buffer.getReadPointer(0), gain, numSamples);
+    for (int ch = 1; ch < buffer.getNumChannels(); ++ch)
+        juce::FloatVectorOperations::addWithMultiply(mono.data(), buffer.getReadPointer(ch), gain, numSamples);
+    return mono.data();
 }
 
-int KickAnalyzer::findOnsetSample(const float* samples, int numSamples, double sampleRate)
+int KickAnalyzer::findOnsetSample(const float* samples, int numSamples, double sampleRate,
+                                  AnalysisWorkspace& workspace)
 {
     if (numSamples <= 0 || sampleRate <= 0.0)
         return 0;
 
     // Short-term average absolute amplitude envelope.
     const int windowSamples = std::max(1, (int)std::round(sampleRate * 0.002)); // 2ms
-    std::vector<double> prefix((size_t)numSamples + 1, 0.0);
+    auto& prefix = workspace.onsetPrefix;
+    prefix.assign((size_t)numSamples + 1, 0.0);
     double globalPeak = 0.0;
 
     for (int i = 0; i < numSamples; ++i)
@@ -360,20 +471,21 @@ int KickAnalyzer::findOnsetSample(const float* samples, int numSamples, double s
         return sum / std::max(1, end - start);
     };
 
-    std::vector<double> env((size_t)numSamples, 0.0);
+    auto& env = workspace.onsetEnvelope;
+    env.resize((size_t)numSamples);
     for (int i = 0; i < numSamples; ++i)
         env[(size_t)i] = avgAbsAt(i);
 
     const int noiseSamples = std::min(numSamples, (int)std::round(sampleRate * 0.10)); // 100ms
-    std::vector<double> noiseVals;
-    noiseVals.reserve((size_t)noiseSamples);
+    auto& noiseVals = workspace.noiseValues;
+    noiseVals.clear();
     for (int i = 0; i < noiseSamples; ++i)
         noiseVals.push_back(env[(size_t)i]);
 
     const double noiseMedian = median(noiseVals);
 
-    std::vector<double> deviations;
-    deviations.reserve(noiseVals.size());
+    auto& deviations = workspace.deviations;
+    deviations.clear();
     for (double v : noiseVals)
         deviations.push_back(std::abs(v - noiseMedian));
 
@@ -417,22 +529,26 @@ int KickAnalyzer::findOnsetSample(const float* samples, int numSamples, double s
     return 0;
 }
 
-double KickAnalyzer::computeTruePeak(const float* samples, int numSamples)
+double KickAnalyzer::computeTruePeak(const float* samples, int numSamples, AnalysisWorkspace& workspace)
 {
     if (numSamples <= 0)
         return 0.0;
 
-    juce::AudioBuffer<float> input(1, numSamples);
-    input.copyFrom(0, 0, samples, numSamples);
+    auto& oversampling = workspace.oversampling;
+    if (oversampling == nullptr)
+        oversampling = std::make_unique<juce::dsp::Oversampling<float>>(
+            1, 2, juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple, true, false); // 4x, FIR, max quality
 
-    juce::dsp::Oversampling<float> oversampling(1, 2, juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple,
-                                                true, false); // 4x, FIR, max quality
-    oversampling.initProcessing((size_t)numSamples);
-    oversampling.reset();
+    // Only re-prepared when the input is longer than any before
+    if ((size_t)numSamples > workspace.oversamplingBlockSize)
+    {
+        oversampling->initProcessing((size_t)numSamples);
+        workspace.oversamplingBlockSize = (size_t)numSamples;
+    }
+    oversampling->reset();
 
-    const juce::AudioBuffer<float>& inputConst = input;
-    juce::dsp::AudioBlock<const float> inputBlock(inputConst);
-    auto upBlock = oversampling.processSamplesUp(inputBlock);
+    juce::dsp::AudioBlock<const float> inputBlock(&samples, 1, (size_t)numSamples);
+    auto upBlock = oversampling->processSamplesUp(inputBlock);
 
     double maxValue = 0.0;
     const float* up = upBlock.getChannelPointer(0);
@@ -453,17 +569,20 @@ double KickAnalyzer::computeRmsDb(const float* samples, int numSamples)
     return juce::Decibels::gainToDecibels((float)rms, -120.0f);
 }
 
-std::vector<double> KickAnalyzer::buildPeakEnvelope(const float* samples, int numSamples)
+void KickAnalyzer::buildPeakEnvelope(const float* samples, int numSamples, AnalysisWorkspace& workspace)
 {
+    auto& env = workspace.envelope;
+    env.clear();
     if (numSamples <= 0)
-        return {};
+        return;
 
-    std::vector<double> absSamples((size_t)numSamples, 0.0);
+    auto& absSamples = workspace.absSamples;
+    absSamples.resize((size_t)numSamples);
     for (int i = 0; i < numSamples; ++i)
         absSamples[(size_t)i] = std::abs(samples[i]);
 
-    std::vector<int> peaks;
-    peaks.reserve((size_t)numSamples / 4);
+    auto& peaks = workspace.peaks;
+    peaks.clear();
 
     peaks.push_back(0);
     for (int i = 1; i < numSamples - 1; ++i)
@@ -478,13 +597,14 @@ std::vector<double> KickAnalyzer::buildPeakEnvelope(const float* samples, int nu
     // Remove duplicates (can occur for very short buffers).
     peaks.erase(std::unique(peaks.begin(), peaks.end()), peaks.end());
 
-    std::vector<double> env((size_t)numSamples, 0.0);
     if (peaks.size() < 2)
     {
-        env = absSamples;
-        return env;
+        env.assign(absSamples.begin(), absSamples.end());
+        return;
     }
 
+    env.assign((size_t)numSamples, 0.0);
+
     for (size_t p = 0; p + 1 < peaks.size(); ++p)
     {
         int i0 = peaks[p];
@@ -509,33 +629,30 @@ std::vector<double> KickAnalyzer::buildPeakEnvelope(const float* samples, int nu
     // Ensure the envelope never drops below the absolute value (robust against flat-top peaks).
     for (int i = 0; i < numSamples; ++i)
         env[(size_t)i] = std::max(env[(size_t)i], absSamples[(size_t)i]);
-
-    return env;
 }
 
-std::vector<float> KickAnalyzer::bandpass(const float* samples, int numSamples, double sampleRate,
-                                         double lowHz, double highHz)
+void KickAnalyzer::bandpass(const float* samples, int numSamples, double sampleRate,
+                            double lowHz, double highHz, std::vector<float>& out)
 {
+    out.clear();
     if (numSamples <= 0 || sampleRate <= 0.0)
-        return {};
+        return;
 
-    std::vector<float> out((size_t)numSamples, 0.0f);
+    out.resize((size_t)numSamples);
 
-    juce::dsp::IIR::Filter<float> hp;
-    juce::dsp::IIR::Filter<float> lp;
+    KickBiquad<float> hp;
+    KickBiquad<float> lp;
     const bool useHp = lowHz > 0.0;
     const bool useLp = highHz > 0.0 && highHz < (sampleRate * 0.5);
 
     if (useHp)
     {
-        hp.coefficients = juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, lowHz);
-        hp.reset();
+        hp.setCoefficients(KickBiquad<float>::Coefficients::makeHighPass(sampleRate, lowHz));
     }
 
     if (useLp)
     {
-        lp.coefficients = juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, highHz);
-        lp.reset();
+        lp.setCoefficients(KickBiquad<float>::Coefficients::makeLowPass(sampleRate, highHz));
     }
 
     for (int i = 0; i < numSamples; ++i)
@@ -547,12 +664,10 @@ std::vector<float> KickAnalyzer::bandpass(const float* samples, int numSamples,
             v = lp.processSample(v);
         out[(size_t)i] = v;
     }
-
-    return out;
 }
 
 double KickAnalyzer::estimatePitchYin(const float* samples, int numSamples, double sampleRate,
-                                      double minHz, double maxHz)
+                                      double minHz, double maxHz, AnalysisWorkspace& workspace)
 {
     if (numSamples <= 0)
         return 0.0;
@@ -562,7 +677,8 @@ double KickAnalyzer::estimatePitchYin(const float* samples, int numSamples, doub
         mean += samples[i];
     mean /= numSamples;
 
-    std::vector<double> x(numSamples);
+    auto& x = workspace.yinInput;
+    x.resize((size_t)numSamples);
     for (int i = 0; i < numSamples; ++i)
         x[i] = samples[i] - mean;
 
@@ -572,19 +688,44 @@ double KickAnalyzer::estimatePitchYin(const float* samples, int numSamples, doub
     if (minTau < 2 || maxTau <= minTau)
         return 0.0;
 
-    std::vector<double> diff(maxTau + 1, 0.0);
-    for (int tau = 1; tau <= maxTau; ++tau)
+    // Difference function d(tau) = sum (x[i] - x[i + tau])^2 over i < numSamples - tau
+    auto& diff = workspace.yinDifference;
+    diff.resize((size_t)maxTau + 1);
+    if (workspace.directYinDifference)
     {
-        double sum = 0.0;
-        for (int i = 0; i < numSamples - tau; ++i)
+        for (int tau = 1; tau <= maxTau; ++tau)
+        {
+            double sum = 0.0;
+            for (int i = 0; i < numSamples - tau; ++i)
+            {
+                const double d = x[(size_t)i] - x[(size_t)(i + tau)];
+                sum += d * d;
+            }
+            diff[(size_t)tau] = sum;
+        }
+    }
+    else
+    {
+        // Expanded into the energies of the two overlapping parts minus twice the autocorrelation,
+        // which comes from one FFT round trip instead of a pass over the window per lag
+        auto& energy = workspace.yinEnergy;
+        energy.resize((size_t)numSamples + 1);
+        energy[0] = 0.0;
+        for (int i = 0; i < numSamples; ++i)
+            energy[(size_t)i + 1] = energy[(size_t)i] + x[(size_t)i] * x[(size_t)i];
+
+        workspace.getFft(numSamples + maxTau + 1).autocorrelate(x.data(), numSamples, diff.data(), maxTau + 1);
+        for (int tau = 1; tau <= maxTau; ++tau)
         {
-            double d = x[i] - x[i + tau];
-            sum += d * d;
+            const double head = energy[(size_t)(numSamples - tau)];
+            const double tail = energy[(size_t)numSamples] - energy[(size_t)tau];
+            diff[(size_t)tau] = std::max(0.0, head + tail - 2.0 * diff[(size_t)tau]);
         }
-        diff[tau] = sum;
     }
+    diff[0] = 0.0;
 
-    std::vector<double> cmndf(maxTau + 1, 1.0);
+    auto& cmndf = workspace.yinCmndf;
+    cmndf.assign((size_t)maxTau + 1, 1.0);
     double runningSum = 0.0;
     for (int tau = 1; tau <= maxTau; ++tau)
     {
@@ -638,17 +779,31 @@ double KickAnalyzer::estimatePitchYin(const float* samples, int numSamples, doub
     return sampleRate / betterTau;
 }
 
+KickRealFft& AnalysisWorkspace::getFft(int minimumSize)
+{
+    int order = 2;
+    while ((1 << order) < minimumSize)
+        ++order;
+
+    for (auto& fft : ffts)
+        if (fft->getOrder() == order)
+            return *fft;
+
+    ffts.push_back(std::make_unique<KickRealFft>(order));
+    return *ffts.back();
+}
+
 double KickAnalyzer::estimatePitchTau(const std::vector<double>& timesMs,
                                       const std::vector<double>& pitchesHz,
-                                      double startHz, double endHz)
+                                      double startHz, double endHz, AnalysisWorkspace& workspace)
 {
     if (timesMs.size() < 3 || startHz <= 0.0 || endHz <= 0.0 || startHz == endHz)
         return 0.0;
 
-    std::vector<double> x;
-    std::vector<double> y;
-    x.reserve(timesMs.size());
-    y.reserve(timesMs.size());
+    auto& x = workspace.tauX;
+    auto& y = workspace.tauY;
+    x.clear();
+    y.clear();
 
     for (size_t i = 0; i < timesMs.size(); ++i)
     {
@@ -707,19 +862,17 @@ double KickAnalyzer::bandRms(const float* samples, int numSamples, double sample
     if (useHp && useLp && lowHz >= highHz)
         return 0.0;
 
-    juce::dsp::IIR::Filter<float> hp;
-    juce::dsp::IIR::Filter<float> lp;
+    KickBiquad<float> hp;
+    KickBiquad<float> lp;
 
     if (useHp)
     {
-        hp.coefficients = juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, lowHz);
-        hp.reset();
+        hp.setCoefficients(KickBiquad<float>::Coefficients::makeHighPass(sampleRate, lowHz));
     }
 
     if (useLp)
     {
-        lp.coefficients = juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, highHz);
-        lp.reset();
+        lp.setCoefficients(KickBiquad<float>::Coefficients::makeLowPass(sampleRate, highHz));
     }
 
     double sum = 0.0;
@@ -750,30 +903,46 @@ double KickAnalyzer::median(std::vector<double>& values)
     return m;
 }
 
-KickMetricScore computeScore(const KickMetrics& target, const KickMetrics& actual)
+KickAnalysisStage getRequiredStage(int termMask)
 {
-    struct Term { double w; double scale; double a; double t; };
-    std::vector<Term> terms = {
-        {1.0, 6.0, actual.peak_dbfs, target.peak_dbfs},
-        {1.0, 6.0, actual.rms_0_100ms_dbfs, target.rms_0_100ms_dbfs},
-        {1.0, 6.0, actual.crest_db, target.crest_db},
-        {1.0, 20.0, actual.attack_ms, target.attack_ms},
-        {3.0, 10.0, actual.t12_ms, target.t12_ms},
-        {3.0, 20.0, actual.t24_ms, target.t24_ms},
-        {2.0, 100.0, actual.tail_ms_to_minus60db, target.tail_ms_to_minus60db},
-        {4.0, 50.0, actual.pitch_start_hz, target.pitch_start_hz},
-        {4.0, 50.0, actual.pitch_end_hz, target.pitch_end_hz},
-        {4.0, 30.0, actual.pitch_tau_ms, target.pitch_tau_ms},
-        {2.0, 20.0, actual.sub_20_60_over_body_60_200, target.sub_20_60_over_body_60_200},
-        {2.0, 10.0, actual.click_2k_10k_over_body_60_200, target.click_2k_10k_over_body_60_200}
-    };
+    if ((termMask & pitchScoreTerms) != 0)
+        return KickAnalysisStage::Pitch;
+    if ((termMask & spectralScoreTerms) != 0)
+        return KickAnalysisStage::Spectral;
+    return KickAnalysisStage::Envelope;
+}
 
+std::array<KickScoreTerm, numKickScoreTerms> getScoreTerms(const KickMetrics& target, const KickMetrics& actual)
+{
+    using Stage = KickAnalysisStage;
+    return {{
+        {Stage::Envelope, levelScoreTerms, 1.0, 6.0, actual.peak_dbfs, target.peak_dbfs},
+        {Stage::Envelope, levelScoreTerms, 1.0, 6.0, actual.rms_0_100ms_dbfs, target.rms_0_100ms_dbfs},
+        {Stage::Envelope, levelScoreTerms, 1.0, 6.0, actual.crest_db, target.crest_db},
+        {Stage::Envelope, envelopeScoreTerms, 1.0, 20.0, actual.attack_ms, target.attack_ms},
+        {Stage::Envelope, envelopeScoreTerms, 3.0, 10.0, actual.t12_ms, target.t12_ms},
+        {Stage::Envelope, envelopeScoreTerms, 3.0, 20.0, actual.t24_ms, target.t24_ms},
+        {Stage::Envelope, envelopeScoreTerms, 2.0, 100.0, actual.tail_ms_to_minus60db, target.tail_ms_to_minus60db},
+        {Stage::Pitch, pitchScoreTerms, 4.0, 50.0, actual.pitch_start_hz, target.pitch_start_hz},
+        {Stage::Pitch, pitchScoreTerms, 4.0, 50.0, actual.pitch_end_hz, target.pitch_end_hz},
+        {Stage::Pitch, pitchScoreTerms, 4.0, 30.0, actual.pitch_tau_ms, target.pitch_tau_ms},
+        {Stage::Spectral, spectralScoreTerms, 2.0, 20.0, actual.sub_20_60_over_body_60_200, target.sub_20_60_over_body_60_200},
+        {Stage::Spectral, spectralScoreTerms, 2.0, 10.0, actual.click_2k_10k_over_body_60_200, target.click_2k_10k_over_body_60_200}
+    }};
+}
+
+KickMetricScore computeScore(const KickMetrics& target, const KickMetrics& actual, KickAnalysisStage measured,
+                             int termMask)
+{
     KickMetricScore score;
-    for (const auto& term : terms)
+    for (const auto& term : getScoreTerms(target, actual))
     {
+        if (term.stage > measured || (term.group & termMask) == 0)
+            continue;
+
         double scale = term.scale > 0.0 ? term.scale : 1.0;
-        double diff = (term.a - term.t) / scale;
-        score.score += term.w * std::abs(diff);
+        double diff = (term.actual - term.target) / scale;
+        score.score += term.weight * std::abs(diff);
     }
     return score;
 }
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "KickRealFft.h"
+#include <array>
+#include <functional>
+#include <memory>
 #include <vector>
 
 struct KickMetrics
@@ -23,6 +27,14 @@ struct KickMetrics
     static KickMetrics fromJson(const juce::var& obj);
 };
 
+// Metric groups in the order analyzeBuffer measures them, cheapest first
+enum class KickAnalysisStage
+{
+    Envelope, // peak, RMS, crest, attack, T12, T24, tail
+    Spectral, // + true peak and the band ratios
+    Pitch     // + pitch start / end / tau: complete
+};
+
 struct KickAnalyzeResult
 {
     KickMetrics metrics;
@@ -30,27 +42,107 @@ struct KickAnalyzeResult
     double trim_ms = 0.0;
     double sample_rate = 0.0;
     int trimmed_samples = 0;
+    bool aborted = false; // analysis stopped early by the abort or stage check; metrics are incomplete
+    KickAnalysisStage completedStage = KickAnalysisStage::Envelope; // last stage measured, when stopped by the stage check
+};
+
+/**
+ * AnalysisWorkspace - Scratch buffers for KickAnalyzer::analyzeBuffer, reused from call to call
+ *
+ * The buffers only ever grow and the true-peak oversampler is prepared for the longest input seen so
+ * far, so once a workspace has analysed a buffer at least as long as the next one, analysis does not
+ * allocate. A workspace is not thread-safe; keep one per thread.
+ */
+class AnalysisWorkspace
+{
+public:
+    AnalysisWorkspace() = default;
+
+    // Computes YIN's difference function by its direct sum, one pass over the window per lag,
+    // instead of from the FFT autocorrelation. Much slower; kept as the reference the FFT path is
+    // checked against (kick_bench --yin-check). Off by default.
+    void setDirectYinDifference(bool shouldUseDirectSum) { directYinDifference = shouldUseDirectSum; }
+
+private:
+    friend class KickAnalyzer;
+
+    // The cached plan of the smallest power-of-two size >= minimumSize, created on first use
+    KickRealFft& getFft(int minimumSize);
+
+    struct PitchPoint
+    {
+        double timeMs = 0.0;
+        double hz = 0.0;
+    };
+
+    std::vector<float> mono;                // channel mix, only used for multichannel input
+    std::vector<double> onsetPrefix;        // findOnsetSample
+    std::vector<double> onsetEnvelope;
+    std::vector<double> noiseValues;
+    std::vector<double> deviations;
+    std::vector<double> absSamples;         // buildPeakEnvelope
+    std::vector<int> peaks;
+    std::vector<double> envelope;
+    std::vector<float> pitchDecimated;      // pitch tracking, at the decimated rate
+    std::vector<float> decimatorScratch;
+    std::vector<float> pitchBandHigh;
+    std::vector<float> pitchBandLow;
+    std::vector<double> yinInput;           // estimatePitchYin, per window
+    std::vector<double> yinEnergy;
+    std::vector<double> yinDifference;
+    std::vector<double> yinCmndf;
+    std::vector<double> timesHiMs, pitchesHiHz;
+    std::vector<double> timesLoMs, pitchesLoHz;
+    std::vector<double> medianValues;
+    std::vector<PitchPoint> fitPoints;
+    std::vector<double> timesFitMs, pitchesFitHz;
+    std::vector<double> tauX, tauY;         // estimatePitchTau
+    std::vector<std::unique_ptr<KickRealFft>> ffts; // one per YIN window size in use
+
+    std::unique_ptr<juce::dsp::Oversampling<float>> oversampling; // true peak, 4x FIR
+    size_t oversamplingBlockSize = 0;
+
+    bool directYinDifference = false;
+
+    JUCE_DECLARE_NON_COPYABLE(AnalysisWorkspace)
 };
 
 class KickAnalyzer
 {
 public:
     static KickAnalyzeResult analyzeFile(const juce::File& file);
-    static KickAnalyzeResult analyzeBuffer(const juce::AudioBuffer<float>& buffer, double sampleRate);
+    // Polled between analysis stages and pitch windows; returning true stops the analysis
+    using AbortCheck = std::function<bool()>;
+
+    // Called after every stage but the last with the metrics measured so far; returning true stops
+    // the analysis there (e.g. once a score lower bound is already too high)
+    using StageCheck = std::function<bool(KickAnalysisStage completed, const KickMetrics& partial)>;
+
+    static KickAnalyzeResult analyzeBuffer(const juce::AudioBuffer<float>& buffer, double sampleRate,
+                                           const AbortCheck& shouldAbort = nullptr,
+                                           const StageCheck& afterStage = nullptr);
+
+    // As above, with scratch buffers from (and left in) workspace; repeated calls on one workspace
+    // do not allocate once it has grown to the longest buffer
+    static KickAnalyzeResult analyzeBuffer(const juce::AudioBuffer<float>& buffer, double sampleRate,
+                                           AnalysisWorkspace& workspace,
+                                           const AbortCheck& shouldAbort = nullptr,
+                                           const StageCheck& afterStage = nullptr);
 
 private:
-    static juce::AudioBuffer<float> toMono(const juce::AudioBuffer<float>& buffer);
-    static int findOnsetSample(const float* samples, int numSamples, double sampleRate);
-    static double computeTruePeak(const float* samples, int numSamples);
+    static const float* toMono(const juce::AudioBuffer<float>& buffer, AnalysisWorkspace& workspace);
+    static int findOnsetSample(const float* samples, int numSamples, double sampleRate,
+                               AnalysisWorkspace& workspace);
+    static double computeTruePeak(const float* samples, int numSamples, AnalysisWorkspace& workspace);
     static double computeRmsDb(const float* samples, int numSamples);
-    static std::vector<double> buildPeakEnvelope(const float* samples, int numSamples);
-    static std::vector<float> bandpass(const float* samples, int numSamples, double sampleRate,
-                                       double lowHz, double highHz);
+    static void buildPeakEnvelope(const float* samples, int numSamples, AnalysisWorkspace& workspace);
+    static void bandpass(const float* samples, int numSamples, double sampleRate,
+                         double lowHz, double highHz, std::vector<float>& out);
     static double estimatePitchYin(const float* samples, int numSamples, double sampleRate,
-                                   double minHz, double maxHz);
+                                   double minHz, double maxHz, AnalysisWorkspace& workspace);
     static double estimatePitchTau(const std::vector<double>& timesMs,
                                    const std::vector<double>& pitchesHz,
-                                   double startHz, double endHz);
+                                   double startHz, double endHz, AnalysisWorkspace& workspace);
     static double bandRms(const float* samples, int numSamples, double sampleRate,
                           double lowHz, double highHz);
     static double median(std::vector<double>& values);
@@ -61,4 +153,37 @@ struct KickMetricScore
     double score = 0.0;
 };
 
-KickMetricScore computeScore(const KickMetrics& target, const KickMetrics& actual);
+// Groups of score terms, combined into a mask to score one aspect of the sound
+enum KickScoreTerms
+{
+    levelScoreTerms = 1 << 0,    // peak, RMS, crest
+    envelopeScoreTerms = 1 << 1, // attack, T12, T24, tail
+    pitchScoreTerms = 1 << 2,    // pitch start / end / tau
+    spectralScoreTerms = 1 << 3, // band ratios
+    allScoreTerms = levelScoreTerms | envelopeScoreTerms | pitchScoreTerms | spectralScoreTerms
+};
+
+// The analysis stage after which every term in termMask is measured
+KickAnalysisStage getRequiredStage(int termMask);
+
+// One term of the score: weight * |actual - target| / scale
+struct KickScoreTerm
+{
+    KickAnalysisStage stage; // stage that measures the metric
+    int group;               // KickScoreTerms bit
+    double weight;
+    double scale;
+    double actual;
+    double target;
+};
+
+constexpr int numKickScoreTerms = 12;
+
+// The terms computeScore sums, always in the same order
+std::array<KickScoreTerm, numKickScoreTerms> getScoreTerms(const KickMetrics& target, const KickMetrics& actual);
+
+// Weighted sum of absolute metric errors over the terms in termMask. With measured before Pitch only
+// the terms of the stages measured so far are summed, which is a lower bound on the complete score.
+KickMetricScore computeScore(const KickMetrics& target, const KickMetrics& actual,
+                             KickAnalysisStage measured = KickAnalysisStage::Pitch,
+                             int termMask = allScoreTerms);
@@ -0,0 +1,131 @@
+#include "KickRealFft.h"
+#include <cmath>
+#include <utility>
+
+namespace
+{
+    using Complex = std::complex<double>;
+
+    // Plain products: std::complex's operator* and norm take slow paths for inf/nan handling
+    inline Complex multiply(Complex a, Complex b)
+    {
+        return { a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real() };
+    }
+
+    inline double squaredMagnitude(Complex a)
+    {
+        return a.real() * a.real() + a.imag() * a.imag();
+    }
+}
+
+KickRealFft::KickRealFft(int fftOrder)
+    : order(fftOrder < 2 ? 2 : fftOrder),
+      size(1 << order),
+      half(size / 2)
+{
+    const double pi = 3.14159265358979323846;
+
+    bitReversed.resize((size_t)half);
+    for (int i = 0, bits = order - 1; i < half; ++i)
+    {
+        int reversed = 0;
+        for (int b = 0; b < bits; ++b)
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        bitReversed[(size_t)i] = reversed;
+    }
+
+    twiddles.resize((size_t)(half / 2));
+    for (int k = 0; k < half / 2; ++k)
+        twiddles[(size_t)k] = std::polar(1.0, -2.0 * pi * k / half);
+
+    splitTwiddles.resize((size_t)half);
+    for (int k = 0; k < half; ++k)
+        splitTwiddles[(size_t)k] = std::polar(1.0, -2.0 * pi * k / size);
+
+    buffer.resize((size_t)half);
+}
+
+void KickRealFft::transform(Complex* data, bool inverse) const
+{
+    for (int i = 0; i < half; ++i)
+    {
+        const int j = bitReversed[(size_t)i];
+        if (i < j)
+            std::swap(data[i], data[j]);
+    }
+
+    // The first pass has only unit twiddles
+    for (int start = 0; start + 1 < half; start += 2)
+    {
+        const Complex u = data[start];
+        const Complex v = data[start + 1];
+        data[start] = u + v;
+        data[start + 1] = u - v;
+    }
+
+    const double sign = inverse ? -1.0 : 1.0;
+    for (int length = 4; length <= half; length <<= 1)
+    {
+        const int step = half / length;
+        const int span = length / 2;
+        for (int start = 0; start < half; start += length)
+        {
+            for (int j = 0; j < span; ++j)
+            {
+                const Complex& t = twiddles[(size_t)(j * step)];
+                const Complex u = data[start + j];
+                const Complex v = multiply(data[start + j + span], { t.real(), sign * t.imag() });
+                data[start + j] = u + v;
+                data[start + j + span] = u - v;
+            }
+        }
+    }
+}
+
+void KickRealFft::autocorrelate(const double* samples, int numSamples, double* result, int numLags)
+{
+    // Even samples in the real part, odd samples in the imaginary part, zero padded
+    for (int n = 0; n < half; ++n)
+    {
+        const int i = 2 * n;
+        buffer[(size_t)n] = { i < numSamples ? samples[i] : 0.0, i + 1 < numSamples ? samples[i + 1] : 0.0 };
+    }
+
+    transform(buffer.data(), false);
+
+    // Split bins k and k + half of the real spectrum out of the packed one, take the power spectrum,
+    // and pack it again for the inverse. Bins k and half - k depend on each other, so both are
+    // rewritten together.
+    auto repack = [this](Complex a, Complex b, int k)
+    {
+        const Complex w = splitTwiddles[(size_t)k];
+        const Complex even = (a + std::conj(b)) * 0.5;
+        const Complex difference = (a - std::conj(b)) * 0.5;
+        const Complex odd = multiply(w, { difference.imag(), -difference.real() });
+
+        const double lowPower = squaredMagnitude(even + odd);
+        const double highPower = squaredMagnitude(even - odd);
+        const double evenPart = 0.5 * (lowPower + highPower);
+        const Complex oddPart = std::conj(w) * (0.5 * (lowPower - highPower));
+        return Complex(evenPart - oddPart.imag(), oddPart.real());
+    };
+
+    for (int k = 0; k <= half / 2; ++k)
+    {
+        const int mirror = (half - k) % half;
+        const Complex a = buffer[(size_t)k];
+        const Complex b = buffer[(size_t)mirror];
+        buffer[(size_t)k] = repack(a, b, k);
+        if (mirror != k)
+            buffer[(size_t)mirror] = repack(b, a, mirror);
+    }
+
+    transform(buffer.data(), true);
+
+    const double scale = 1.0 / half;
+    for (int lag = 0; lag < numLags && lag < size; ++lag)
+    {
+        const Complex& z = buffer[(size_t)(lag / 2)];
+        result[lag] = ((lag & 1) == 0 ? z.real() : z.imag()) * scale;
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <complex>
+#include <vector>
+
+/**
+ * KickRealFft - Double-precision FFT of real signals, for autocorrelation in the analyser
+ *
+ * A plan for one power-of-two size: the bit-reversal table and twiddle factors are computed once, and
+ * a real transform of size N runs as a complex radix-2 transform of size N / 2 with the usual
+ * even/odd split. juce::dsp::FFT is single precision, which is not enough for YIN's difference
+ * function (a small difference of large energies). A plan keeps its own scratch buffer, so it is not
+ * thread-safe.
+ */
+class KickRealFft
+{
+public:
+    // Size 2^order, order >= 2
+    explicit KickRealFft(int order);
+
+    int getOrder() const { return order; }
+    int getSize() const { return size; }
+
+    // Linear (not circular) autocorrelation r[lag] = sum_i x[i] * x[i + lag] for lag < numLags;
+    // needs numSamples + numLags <= getSize()
+    void autocorrelate(const double* samples, int numSamples, double* result, int numLags);
+
+private:
+    // In place, unscaled; inverse uses conjugate twiddles
+    void transform(std::complex<double>* data, bool inverse) const;
+
+    int order;
+    int size;
+    int half; // size of the complex transform
+    std::vector<int> bitReversed;
+    std::vector<std::complex<double>> twiddles;     // e^(-2 pi i k / half), k < half / 2
+    std::vector<std::complex<double>> splitTwiddles; // e^(-2 pi i k / size), k < half
+    std::vector<std::complex<double>> buffer;
+};
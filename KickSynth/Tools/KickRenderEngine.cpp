@@ -1,64 +1,112 @@
 #include "KickRenderEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+int KickRenderEngine::getRenderLength(const KickParams& params, double sampleRate)
+{
+    const double lengthMs = std::max(300.0, (double)params.tailMsToMinus60Db + 200.0);
+    return std::max(1, (int)std::round(sampleRate * (lengthMs / 1000.0)));
+}
 
 void KickRenderEngine::prepare(double sampleRate)
 {
-    currentSampleRate = sampleRate;
-    distortion.prepare(sampleRate, 512);
-    limiter.prepare(sampleRate, 512);
-    outputHPFCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 20.0f);
-    outputHPF.coefficients = outputHPFCoeffs;
-    outputHPF.reset();
+    chain.prepare(sampleRate);
 }
 
 void KickRenderEngine::render(const KickParams& params, float velocity, juce::AudioBuffer<float>& buffer)
 {
-    if (buffer.getNumSamples() == 0)
-        return;
-
-    // Setup voice parameters
-    voice.setBodyLevel(params.bodyLevel);
-    voice.setClickLevel(params.clickLevel);
-    voice.setPitchStartHz(params.pitchStartHz);
-    voice.setPitchEndHz(params.pitchEndHz);
-    voice.setPitchTauMs(params.pitchTauMs);
-    voice.setAttackMs(params.attackMs);
-    voice.setT12Ms(params.t12Ms);
-    voice.setT24Ms(params.t24Ms);
-    voice.setTailMsToMinus60Db(params.tailMsToMinus60Db);
-    voice.setClickDecayMs(params.clickDecayMs);
-    voice.setClickHPFHz(params.clickHPFHz);
-    voice.setBodyOscillatorType(params.bodyOscType);
-    voice.setKeyTracking(params.keyTracking);
-    voice.setRetriggerMode(params.retriggerMode);
-    voice.setVelocitySensitivity(params.velocitySensitivity);
-
-    distortion.setDistortionType(params.distortionType);
-    distortion.setDrive(params.drive);
-    distortion.setAsymmetry(params.asymmetry);
-
-    limiter.setLimiterEnabled(params.limiterEnabled);
-    limiter.setOutputGain(params.outputGainDb);
-
-    outputHPFCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighPass(currentSampleRate, params.outputHPFHz);
-    outputHPF.coefficients = outputHPFCoeffs;
-    outputHPF.reset();
+    render(params, velocity, buffer, nullptr);
+}
+
+void KickRenderEngine::startChain(KickSignalChain& chain, const KickParams& params, float velocity, int layerMask)
+{
+    // Same chain as the plugin, with every control settled at the snapshot values
+    if (layerMask == allLayers)
+    {
+        chain.setParameters(params);
+    }
+    else
+    {
+        KickParams layerParams = params;
+        if ((layerMask & bodyLayer) == 0)
+            layerParams.bodyLevel = 0.0f;
+        if ((layerMask & clickLayer) == 0)
+            layerParams.clickLevel = 0.0f;
+        chain.setParameters(layerParams);
+    }
+    chain.setDistortionBypassed((layerMask & distortionLayer) == 0);
+    chain.snapParameters();
+    chain.reset();
 
     // Trigger voice
-    voice.noteOn(60, velocity, currentSampleRate);
+    chain.noteOn(60, velocity);
+}
+
+bool KickRenderEngine::render(const KickParams& params, float velocity, juce::AudioBuffer<float>& buffer,
+                              const std::function<bool()>& shouldAbort)
+{
+    if (buffer.getNumSamples() == 0)
+        return true;
+
+    startChain(chain, params, velocity, layerMask);
 
     buffer.clear();
-    for (int i = 0; i < buffer.getNumSamples(); ++i)
+    auto* data = buffer.getWritePointer(0);
+    const int numSamples = buffer.getNumSamples();
+    const int latency = juce::jmin(chain.getLatencySamples(), numSamples);
+
+    // With skipSilentTail, rendering ends at the first slice that is silent once the voice has
+    // stopped and the lookahead has drained
+    const int sliceSamples = skipSilentTail ? tailCheckInterval : abortCheckInterval;
+    int silentCheckFrom = -1;
+    int stopSample = numSamples;
+
+    for (int startSample = 0; startSample < numSamples; startSample += sliceSamples)
     {
-        float sample = voice.renderSample();
-        buffer.setSample(0, i, sample);
+        if (shouldAbort && shouldAbort())
+            return false;
+
+        const int sliceLength = std::min(sliceSamples, numSamples - startSample);
+        chain.process(data + startSample, sliceLength);
+
+        if (!skipSilentTail)
+            continue;
+
+        if (silentCheckFrom < 0 && !chain.getVoice().isActive())
+            silentCheckFrom = startSample + sliceLength + chain.getLatencySamples();
+
+        if (silentCheckFrom >= 0 && startSample >= silentCheckFrom)
+        {
+            const auto range = juce::FloatVectorOperations::findMinAndMax(data + startSample, sliceLength);
+            if (std::max(-range.getStart(), range.getEnd()) < silenceThreshold)
+            {
+                stopSample = startSample + sliceLength;
+                break;
+            }
+        }
     }
 
-    // Apply output HPF
-    auto* data = buffer.getWritePointer(0);
-    for (int i = 0; i < buffer.getNumSamples(); ++i)
-        data[i] = outputHPF.processSample(data[i]);
+    // Compensate the lookahead latency so renders stay aligned with the note-on: run the chain for
+    // the extra samples and drop the leading ones (after an early stop the extra samples are silent)
+    if (latency > 0)
+    {
+        std::memmove(data, data + latency, sizeof(float) * (size_t)(numSamples - latency));
+        if (stopSample < numSamples)
+        {
+            juce::FloatVectorOperations::clear(data + numSamples - latency, latency);
+        }
+        else
+        {
+            latencyScratch.resize((size_t)latency);
+            chain.process(latencyScratch.data(), latency);
+            std::copy(latencyScratch.begin(), latencyScratch.end(), data + numSamples - latency);
+        }
+    }
+
+    // Fan out to any extra channels
+    for (int channel = 1; channel < buffer.getNumChannels(); ++channel)
+        juce::FloatVectorOperations::copy(buffer.getWritePointer(channel), data, numSamples);
 
-    // Distortion & limiter
-    distortion.processBlock(buffer);
-    limiter.processBlock(buffer);
+    return true;
 }
@@ -2,21 +2,55 @@
 
 #include <JuceHeader.h>
 #include "KickParams.h"
-#include "../Source/DSP/KickVoice.h"
-#include "../Source/DSP/KickDistortion.h"
-#include "../Source/DSP/KickLimiter.h"
+#include "../Source/DSP/KickSignalChain.h"
+#include <functional>
+#include <vector>
 
 class KickRenderEngine
 {
 public:
+    // Layers of the kick, combined into a mask for setLayerMask
+    enum Layer
+    {
+        bodyLayer = 1 << 0,
+        clickLayer = 1 << 1,
+        distortionLayer = 1 << 2,
+        allLayers = bodyLayer | clickLayer | distortionLayer
+    };
+
+    // Samples in an analysis render (kick_fit, kick_train, the editor preview): the whole tail plus
+    // 200 ms of silence, at least 300 ms
+    static int getRenderLength(const KickParams& params, double sampleRate);
+
     void prepare(double sampleRate);
     void render(const KickParams& params, float velocity, juce::AudioBuffer<float>& buffer);
 
+    // As above, polling shouldAbort between slices of the render; returns false (leaving the buffer
+    // partly rendered) when it asked to stop
+    bool render(const KickParams& params, float velocity, juce::AudioBuffer<float>& buffer,
+                const std::function<bool()>& shouldAbort);
+
+    // Stops rendering once the voice has gone inactive and the effects have rung out below
+    // -120 dBFS, leaving the rest of the buffer silent. The skipped tail is not exactly zero, so the
+    // output is no longer bit-identical to the plugin; off by default.
+    void setSkipSilentTail(bool shouldSkip) { skipSilentTail = shouldSkip; }
+
+    // Renders only the given layers (e.g. the body alone, for fitting its pitch): a missing body or
+    // click layer is rendered at zero level and a missing distortion layer is bypassed
+    void setLayerMask(int mask) { layerMask = mask; }
+
+    // What a render starts with: the chain set to params (layers outside layerMask removed), every
+    // control settled, the effects reset and note 60 triggered at velocity
+    static void startChain(KickSignalChain& chain, const KickParams& params, float velocity, int layerMask);
+
 private:
-    double currentSampleRate = 48000.0;
-    KickVoice voice;
-    KickDistortion distortion;
-    KickLimiter limiter;
-    juce::dsp::IIR::Filter<float> outputHPF;
-    juce::dsp::IIR::Coefficients<float>::Ptr outputHPFCoeffs;
+    static constexpr int abortCheckInterval = 4096; // samples between shouldAbort polls
+    static constexpr int tailCheckInterval = 256;   // samples between voice activity checks
+    static constexpr float silenceThreshold = 1.0e-6f; // -120 dBFS
+
+    bool skipSilentTail = false;
+    int layerMask = allLayers;
+
+    KickSignalChain chain;
+    std::vector<float> latencyScratch;
 };
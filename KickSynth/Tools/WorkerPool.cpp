@@ -0,0 +1,37 @@
+#include "WorkerPool.h"
+#include <atomic>
+#include <memory>
+
+void runOnWorkers(juce::ThreadPool* pool, int numWorkers, const std::function<void(int worker)>& job)
+{
+    if (numWorkers <= 1)
+    {
+        if (numWorkers == 1)
+            job(0);
+        return;
+    }
+
+    jassert(pool != nullptr && pool->getNumThreads() >= numWorkers - 1);
+    std::atomic<int> remaining { numWorkers - 1 };
+    juce::WaitableEvent finished;
+    for (int worker = 1; worker < numWorkers; ++worker)
+    {
+        pool->addJob([&, worker]()
+        {
+            job(worker);
+            if (--remaining == 0)
+                finished.signal();
+        });
+    }
+
+    job(0);
+    finished.wait();
+}
+
+void runOnWorkers(int numWorkers, const std::function<void(int worker)>& job)
+{
+    std::unique_ptr<juce::ThreadPool> pool;
+    if (numWorkers > 1)
+        pool = std::make_unique<juce::ThreadPool>(numWorkers - 1);
+    runOnWorkers(pool.get(), numWorkers, job);
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+
+// Runs job(worker) for worker 0 to numWorkers - 1 and returns once every call has finished. Worker 0
+// runs on the calling thread and the others on pool, which needs numWorkers - 1 threads (none for
+// a single worker); the tools give each worker index its own render engine and buffers.
+void runOnWorkers(juce::ThreadPool* pool, int numWorkers, const std::function<void(int worker)>& job);
+
+// As above, on a pool created for the call
+void runOnWorkers(int numWorkers, const std::function<void(int worker)>& job);
@@ -0,0 +1,499 @@
+#include "../Source/DSP/KickVoice.h"
+#include "../Source/DSP/KickDistortion.h"
+#include "../Source/DSP/KickOscillator.h"
+#include "KickBatchRenderEngine.h"
+#include "KickGradientModel.h"
+#include "KickInverseModel.h"
+#include "KickMetrics.h"
+#include "KickRenderEngine.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+
+// Times the voice and distortion kernels for every discrete combination: one dispatch per sample
+// (renderSample / processSample) against one dispatch per 64-sample block (renderBlock / processBlock).
+// The full chain is timed for numLanes different kicks rendered one at a time on KickRenderEngine
+// against one pass of KickBatchRenderEngine.
+// With --alias it instead measures the aliasing of the body oscillator shapes, with --yin-check
+// it compares the analyser's FFT-based YIN difference function with the direct sum, and with
+// --model-check it compares kick_fit's gradient model with the renderer.
+
+static constexpr int benchBlockSize = 64;
+
+template <typename Function>
+static double timeBestOfMs(int reps, Function&& function)
+{
+    double best = 1.0e30;
+    for (int rep = 0; rep < reps; ++rep)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+template <int Shape>
+static void renderBandLimited(float* output, int numSamples, float dt)
+{
+    float phase = 0.0f;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        output[i] = KickOscillator::render<Shape>(phase, dt);
+        phase += dt;
+        if (phase >= 1.0f)
+            phase -= 1.0f;
+    }
+}
+
+// Power outside the harmonics of f relative to the power on them, in dB (steady tone, 4-term
+// Blackman-Harris window, +-8 bins around each harmonic count as signal)
+static double measureAliasDb(int shape, bool bandLimited, double frequencyHz, double sampleRate)
+{
+    constexpr int fftOrder = 16;
+    constexpr int fftSize = 1 << fftOrder;
+    constexpr int harmonicHalfWidth = 8;
+
+    std::vector<float> data((size_t)fftSize * 2, 0.0f);
+    const float dt = (float)(frequencyHz / sampleRate);
+    if (bandLimited)
+    {
+        switch (shape)
+        {
+            case KickOscillator::triangle: renderBandLimited<KickOscillator::triangle>(data.data(), fftSize, dt); break;
+            case KickOscillator::saw:      renderBandLimited<KickOscillator::saw>(data.data(), fftSize, dt); break;
+            case KickOscillator::square:   renderBandLimited<KickOscillator::square>(data.data(), fftSize, dt); break;
+            default:                       renderBandLimited<KickOscillator::sine>(data.data(), fftSize, dt); break;
+        }
+    }
+    else
+    {
+        float phase = 0.0f;
+        for (int i = 0; i < fftSize; ++i)
+        {
+            data[(size_t)i] = KickOscillator::renderNaive(shape, phase);
+            phase += dt;
+            if (phase >= 1.0f)
+                phase -= 1.0f;
+        }
+    }
+
+    const double twoPi = juce::MathConstants<double>::twoPi;
+    for (int i = 0; i < fftSize; ++i)
+    {
+        const double x = (double)i / (double)fftSize;
+        const double window = 0.35875 - 0.48829 * std::cos(twoPi * x) + 0.14128 * std::cos(2.0 * twoPi * x)
+                            - 0.01168 * std::cos(3.0 * twoPi * x);
+        data[(size_t)i] *= (float)window;
+    }
+
+    juce::dsp::FFT fft(fftOrder);
+    fft.performFrequencyOnlyForwardTransform(data.data(), true);
+
+    std::vector<bool> isHarmonic((size_t)fftSize / 2 + 1, false);
+    for (int harmonic = 0; harmonic * frequencyHz < 0.5 * sampleRate; ++harmonic)
+    {
+        const int centre = (int)std::lround(harmonic * frequencyHz * fftSize / sampleRate);
+        for (int bin = centre - harmonicHalfWidth; bin <= centre + harmonicHalfWidth; ++bin)
+            if (bin >= 0 && bin <= fftSize / 2)
+                isHarmonic[(size_t)bin] = true;
+    }
+
+    double signalPower = 0.0;
+    double aliasPower = 0.0;
+    for (int bin = 0; bin <= fftSize / 2; ++bin)
+    {
+        const double power = (double)data[(size_t)bin] * (double)data[(size_t)bin];
+        (isHarmonic[(size_t)bin] ? signalPower : aliasPower) += power;
+    }
+
+    return 10.0 * std::log10(std::max(aliasPower, 1.0e-30) / std::max(signalPower, 1.0e-30));
+}
+
+// Alias check over the body sweep range: every band-limited shape must beat its naive version by
+// at least its minImprovementDb, unless the band-limited alias power is below floorDb. The
+// thresholds sit 1.5-2 dB under what the shapes reach at 44.1 kHz: the PolyBLAMP triangle gains
+// 10.4-12.5 dB, the PolyBLEP saw and square 14.8-16.3 dB.
+static int runAliasCheck(double sampleRate)
+{
+    constexpr double minImprovementDb[] = { 0.0, 9.0, 13.0, 13.0 }; // per shape, sine unchecked
+    constexpr double floorDb = -90.0;
+    const char* shapeNames[] = { "Sine", "Triangle", "Saw", "Square" };
+
+    std::cout << "Alias check at " << sampleRate << " Hz (alias / harmonic power)\n";
+    std::cout << "  shape     freq Hz   naive dB  band-limited dB  improvement\n";
+    std::cout << std::fixed;
+
+    bool passed = true;
+    for (int shape = KickOscillator::triangle; shape < KickOscillator::numShapes; ++shape)
+    {
+        // Off-grid frequencies so aliases do not land on harmonics
+        for (double frequencyHz : { 20.3, 55.1, 110.7, 220.9, 347.3, 499.1 })
+        {
+            const double naiveDb = measureAliasDb(shape, false, frequencyHz, sampleRate);
+            const double bandLimitedDb = measureAliasDb(shape, true, frequencyHz, sampleRate);
+            const bool ok = bandLimitedDb <= naiveDb - minImprovementDb[shape] || bandLimitedDb <= floorDb;
+            passed = passed && ok;
+
+            std::cout << "  " << std::left << std::setw(10) << shapeNames[shape] << std::right
+                      << std::setw(7) << std::setprecision(1) << frequencyHz
+                      << std::setw(11) << naiveDb
+                      << std::setw(17) << bandLimitedDb
+                      << std::setw(13) << naiveDb - bandLimitedDb
+                      << (ok ? "" : "  FAIL") << "\n";
+        }
+    }
+
+    std::cout << (passed ? "PASS" : "FAIL") << "\n";
+    return passed ? 0 : 1;
+}
+
+// YIN check: random kicks (drawn as kick_train draws them) analysed with the FFT difference function
+// and with the direct-sum reference. The pitch metrics, the only ones YIN feeds, must agree within
+// a relative tolerance; the FFT path rounds differently, so they are not bit-identical.
+static int runYinCheck(double sampleRate)
+{
+    constexpr int numKicks = 100;
+    constexpr double tolerance = 1.0e-6;
+
+    struct PitchMetric
+    {
+        const char* name;
+        double KickMetrics::* member;
+        double worstDeviation = 0.0;
+    };
+    PitchMetric pitchMetrics[] = { { "pitch_start_hz", &KickMetrics::pitch_start_hz },
+                                   { "pitch_end_hz", &KickMetrics::pitch_end_hz },
+                                   { "pitch_tau_ms", &KickMetrics::pitch_tau_ms } };
+
+    std::cout << "YIN check at " << sampleRate << " Hz: FFT against direct-sum difference function on "
+              << numKicks << " rendered kicks\n";
+    std::cout << std::scientific;
+
+    std::mt19937 rng(1);
+    KickRenderEngine engine;
+    engine.prepare(sampleRate);
+    juce::AudioBuffer<float> buffer;
+    AnalysisWorkspace fftWorkspace;
+    AnalysisWorkspace directWorkspace;
+    directWorkspace.setDirectYinDifference(true);
+
+    double fftMs = 0.0;
+    double directMs = 0.0;
+    bool passed = true;
+    for (int kick = 0; kick < numKicks; ++kick)
+    {
+        const auto params = KickInverseModel::drawParams(rng, 1);
+        buffer.setSize(1, KickRenderEngine::getRenderLength(params, sampleRate), false, false, true);
+        engine.render(params, 1.0f, buffer);
+
+        KickMetrics fft, direct;
+        fftMs += timeBestOfMs(1, [&] { fft = KickAnalyzer::analyzeBuffer(buffer, sampleRate, fftWorkspace).metrics; });
+        directMs += timeBestOfMs(1, [&] { direct = KickAnalyzer::analyzeBuffer(buffer, sampleRate, directWorkspace).metrics; });
+
+        for (auto& metric : pitchMetrics)
+        {
+            const double reference = direct.*metric.member;
+            const double deviation = std::abs(fft.*metric.member - reference) / std::max(1.0, std::abs(reference));
+            metric.worstDeviation = std::max(metric.worstDeviation, deviation);
+            if (deviation > tolerance)
+            {
+                passed = false;
+                std::cout << "  kick " << kick << " " << metric.name << ": FFT " << fft.*metric.member
+                          << ", direct " << reference << "  FAIL\n";
+            }
+        }
+    }
+
+    std::cout << "  metric          worst relative deviation (tolerance " << tolerance << ")\n";
+    for (const auto& metric : pitchMetrics)
+        std::cout << "  " << std::left << std::setw(16) << metric.name << std::right << metric.worstDeviation << "\n";
+    std::cout << std::fixed << std::setprecision(2) << "  analysis per kick: FFT " << fftMs / numKicks
+              << " ms, direct " << directMs / numKicks << " ms\n";
+
+    std::cout << (passed ? "PASS" : "FAIL") << "\n";
+    return passed ? 0 : 1;
+}
+
+// Model check: random kicks with the distortion and the limiter off, the parts the gradient model
+// simplifies, rendered by KickGradientModel on duals and by KickRenderEngine. Both run KickVoice's
+// render kernels, so the outputs differ by precision only: the engine accumulates the body phase in
+// float and the model in double, which drifts apart over the tail. On these kicks the model sits
+// within 4e-3 of the peak, and the same kernels run in float and double differ by up to 6.5e-3; a
+// naive body or a different envelope is off by far more than the tolerance.
+static int runModelCheck()
+{
+    constexpr int numKicks = 50;
+    constexpr double tolerance = 1.0e-2; // relative to the peak
+
+    std::cout << "Model check: KickGradientModel against KickRenderEngine on " << numKicks
+              << " kicks per rate (distortion and limiter off)\n";
+    std::cout << "  rate Hz   worst deviation / peak (tolerance " << std::scientific << std::setprecision(1)
+              << tolerance << ")\n";
+
+    bool passed = true;
+    for (double sampleRate : { 44100.0, 96000.0 })
+    {
+        std::mt19937 rng(2);
+        KickRenderEngine engine;
+        engine.prepare(sampleRate);
+        KickGradientModel model(sampleRate);
+        juce::AudioBuffer<float> buffer;
+
+        double worstDeviation = 0.0;
+        for (int kick = 0; kick < numKicks; ++kick)
+        {
+            auto params = KickInverseModel::drawParams(rng, 0);
+            params.drive = 0.0f;
+            params.limiterEnabled = false;
+            params.limiterMode = 0;
+            params.keyTracking = kick % 3 == 0 ? 7.0f : 0.0f;
+            params.attackMs = kick % 4 == 0 ? 0.0f : params.attackMs;
+            params = params.clamped();
+
+            buffer.setSize(1, KickRenderEngine::getRenderLength(params, sampleRate), false, false, true);
+            engine.render(params, 1.0f, buffer);
+            const auto& modelOutput = model.render(params);
+
+            const auto* data = buffer.getReadPointer(0);
+            double peak = 0.0;
+            double deviation = 0.0;
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                peak = std::max(peak, std::abs((double)data[i]));
+                deviation = std::max(deviation, std::abs(modelOutput[(size_t)i].getValue() - (double)data[i]));
+            }
+            deviation /= std::max(peak, 1.0e-9);
+            worstDeviation = std::max(worstDeviation, deviation);
+
+            if (deviation > tolerance)
+            {
+                passed = false;
+                std::cout << "  " << std::fixed << std::setprecision(0) << sampleRate << " kick " << kick
+                          << " (osc " << params.bodyOscType << "): " << std::scientific << std::setprecision(2)
+                          << deviation << "  FAIL\n";
+            }
+        }
+
+        std::cout << "  " << std::fixed << std::setprecision(0) << std::setw(7) << sampleRate
+                  << std::scientific << std::setprecision(2) << std::setw(14) << worstDeviation << "\n";
+    }
+
+    std::cout << (passed ? "PASS" : "FAIL") << "\n";
+    return passed ? 0 : 1;
+}
+
+static void configureVoice(KickVoice& voice, int oscType, float keyTracking, float attackMs, double lengthMs)
+{
+    voice.setBodyOscillatorType(oscType);
+    voice.setKeyTracking(keyTracking);
+    voice.setAttackMs(attackMs);
+    // Keep the voice alive for the whole render so every combination does the same work
+    voice.setTailMsToMinus60Db((float)lengthMs);
+}
+
+int main(int argc, char* argv[])
+{
+    double sampleRate = 48000.0;
+    double lengthMs = 500.0;
+    int reps = 20;
+    bool aliasCheck = false;
+    bool yinCheck = false;
+    bool modelCheck = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        juce::String arg = argv[i];
+        if (arg == "--sr" && i + 1 < argc)
+            sampleRate = juce::String(argv[++i]).getDoubleValue();
+        else if (arg == "--length-ms" && i + 1 < argc)
+            lengthMs = juce::String(argv[++i]).getDoubleValue();
+        else if (arg == "--reps" && i + 1 < argc)
+            reps = std::max(1, juce::String(argv[++i]).getIntValue());
+        else if (arg == "--alias")
+            aliasCheck = true;
+        else if (arg == "--yin-check")
+            yinCheck = true;
+        else if (arg == "--model-check")
+            modelCheck = true;
+        else
+        {
+            std::cout << "Usage: kick_bench [--sr 48000] [--length-ms 500] [--reps 20] [--alias] [--yin-check] [--model-check]\n";
+            return 1;
+        }
+    }
+
+    if (aliasCheck)
+        return runAliasCheck(44100.0);
+    if (yinCheck)
+        return runYinCheck(sampleRate);
+    if (modelCheck)
+        return runModelCheck();
+
+    const int numSamples = std::max(1, (int)std::round(sampleRate * (lengthMs / 1000.0)));
+    std::vector<float> output((size_t)numSamples);
+    std::vector<float> reference((size_t)numSamples);
+
+    std::cout << "Rendering " << numSamples << " samples at " << sampleRate << " Hz, best of " << reps << "\n\n";
+    std::cout << std::fixed;
+
+    // Voice: oscillator x key tracking x attack (the body rate follows --sr)
+    std::cout << "Voice (body divider " << KickVoice::getBodyDividerForSampleRate(sampleRate) << ")\n";
+    std::cout << "  osc       keyTrack  attack   per-sample ms  block ms  speedup\n";
+    const char* oscNames[] = { "Sine", "Triangle", "Saw", "Square" };
+    for (int oscType = 0; oscType < KickOscillator::numShapes; ++oscType)
+    {
+        for (float keyTracking : { 0.0f, 7.0f })
+        {
+            for (float attackMs : { 0.0f, 5.0f })
+            {
+                KickVoice voice;
+                voice.prepare(sampleRate);
+                configureVoice(voice, oscType, keyTracking, attackMs, lengthMs);
+
+                const double perSampleMs = timeBestOfMs(reps, [&]
+                {
+                    voice.noteOn(48, 1.0f, sampleRate);
+                    for (int i = 0; i < numSamples; ++i)
+                        output[(size_t)i] = voice.renderSample();
+                });
+                reference = output;
+
+                const double blockMs = timeBestOfMs(reps, [&]
+                {
+                    voice.noteOn(48, 1.0f, sampleRate);
+                    for (int start = 0; start < numSamples; start += benchBlockSize)
+                        voice.renderBlock(output.data() + start, std::min(benchBlockSize, numSamples - start));
+                });
+
+                std::cout << "  " << std::left << std::setw(10) << oscNames[oscType]
+                          << std::setw(10) << (keyTracking != 0.0f ? "on" : "off")
+                          << std::setw(9) << (attackMs != 0.0f ? "on" : "off") << std::right
+                          << std::setw(13) << std::setprecision(3) << perSampleMs
+                          << std::setw(10) << blockMs
+                          << std::setw(8) << std::setprecision(2) << perSampleMs / std::max(blockMs, 1.0e-9) << "x"
+                          << (output == reference ? "" : "  MISMATCH") << "\n";
+            }
+        }
+    }
+
+    // Distortion: type x antialiasing order on a rendered kick
+    KickVoice source;
+    source.prepare(sampleRate);
+    configureVoice(source, 0, 0.0f, 0.0f, lengthMs);
+    source.noteOn(60, 1.0f, sampleRate);
+    std::vector<float> input((size_t)numSamples);
+    source.renderBlock(input.data(), numSamples);
+
+    const char* typeNames[] = { "Tanh", "Hard Clip", "Asymmetric" };
+    const char* orderNames[] = { "Off", "ADAA1", "ADAA2" };
+
+    std::cout << "\nDistortion (drive 0.5, asymmetry 0.3)\n";
+    std::cout << "  type        AA       per-sample ms  block ms  speedup\n";
+    for (int type = 0; type <= 2; ++type)
+    {
+        for (int order = 0; order <= 2; ++order)
+        {
+            KickDistortion distortion;
+            distortion.prepare(sampleRate, benchBlockSize);
+            distortion.setDistortionType(type);
+            distortion.setAntialiasing(order);
+            distortion.setDrive(0.5f);
+            distortion.setAsymmetry(0.3f);
+
+            const double perSampleMs = timeBestOfMs(reps, [&]
+            {
+                distortion.reset();
+                for (int i = 0; i < numSamples; ++i)
+                    output[(size_t)i] = distortion.processSample(input[(size_t)i]);
+            });
+            reference = output;
+
+            const double blockMs = timeBestOfMs(reps, [&]
+            {
+                distortion.reset();
+                output = input;
+                for (int start = 0; start < numSamples; start += benchBlockSize)
+                    distortion.processBlock(output.data() + start, std::min(benchBlockSize, numSamples - start));
+            });
+
+            std::cout << "  " << std::left << std::setw(12) << typeNames[type]
+                      << std::setw(9) << orderNames[order] << std::right
+                      << std::setw(13) << std::setprecision(3) << perSampleMs
+                      << std::setw(10) << blockMs
+                      << std::setw(8) << std::setprecision(2) << perSampleMs / std::max(blockMs, 1.0e-9) << "x"
+                      << (output == reference ? "" : "  MISMATCH") << "\n";
+        }
+    }
+
+    // Full chain: numLanes parameter sets per oscillator, one render each against one batch pass
+    constexpr int numLanes = KickBatchRenderEngine::numLanes;
+    std::cout << "\nRender engine (" << numLanes << " kicks, skip silent tail)\n";
+    std::cout << "  osc       one at a time ms  batch ms  speedup\n";
+
+    KickRenderEngine engine;
+    engine.prepare(sampleRate);
+    engine.setSkipSilentTail(true);
+    KickBatchRenderEngine batchEngine;
+    batchEngine.prepare(sampleRate);
+    batchEngine.setSkipSilentTail(true);
+
+    std::array<juce::AudioBuffer<float>, numLanes> singleBuffers, batchBuffers;
+    std::array<juce::AudioBuffer<float>*, numLanes> batchPointers {};
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        singleBuffers[(size_t)lane].setSize(1, numSamples);
+        batchBuffers[(size_t)lane].setSize(1, numSamples);
+        batchPointers[(size_t)lane] = &batchBuffers[(size_t)lane];
+    }
+
+    for (int oscType = 0; oscType < KickOscillator::numShapes; ++oscType)
+    {
+        std::array<KickParams, numLanes> params;
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            auto& p = params[(size_t)lane];
+            p.bodyOscType = oscType;
+            p.pitchStartHz = 180.0f + 30.0f * (float)lane;
+            p.pitchTauMs = 10.0f + 5.0f * (float)lane;
+            p.tailMsToMinus60Db = (float)lengthMs * (0.4f + 0.05f * (float)lane);
+            p.clickLevel = 0.1f * (float)lane;
+            p.drive = 0.1f * (float)lane;
+            p.distortionType = lane % 3;
+            p.distortionAntialiasing = lane % 2;
+            p.limiterMode = (lane / 2) % 2;
+            p = p.clamped();
+        }
+
+        const double singleMs = timeBestOfMs(reps, [&]
+        {
+            for (int lane = 0; lane < numLanes; ++lane)
+                engine.render(params[(size_t)lane], 1.0f, singleBuffers[(size_t)lane]);
+        });
+
+        const double batchMs = timeBestOfMs(reps, [&]
+        {
+            batchEngine.render(params.data(), numLanes, 1.0f, batchPointers.data());
+        });
+
+        bool matches = true;
+        for (int lane = 0; lane < numLanes; ++lane)
+            matches = matches && std::equal(singleBuffers[(size_t)lane].getReadPointer(0),
+                                            singleBuffers[(size_t)lane].getReadPointer(0) + numSamples,
+                                            batchBuffers[(size_t)lane].getReadPointer(0));
+
+        std::cout << "  " << std::left << std::setw(10) << oscNames[oscType] << std::right
+                  << std::setw(16) << std::setprecision(3) << singleMs
+                  << std::setw(10) << batchMs
+                  << std::setw(8) << std::setprecision(2) << singleMs / std::max(batchMs, 1.0e-9) << "x"
+                  << (matches ? "" : "  MISMATCH") << "\n";
+    }
+
+    return 0;
+}
@@ -1,148 +1,598 @@
 #include "KickMetrics.h"
 #include "KickRenderEngine.h"
+#include "KickBatchRenderEngine.h"
 #include "KickParams.h"
+#include "WorkerPool.h"
+#include "CmaEs.h"
+#include "KickGradientModel.h"
+#include "KickInverseModel.h"
 #include <iostream>
 #include <array>
+#include <atomic>
+#include <memory>
 #include <random>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iomanip>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
 
 struct Candidate
 {
     KickParams params;
     KickMetrics metrics;
     double score = 0.0;
+    bool complete = true; // false: rejected early, metrics are partial and score is a lower bound
+    KickAnalysisStage measuredStage = KickAnalysisStage::Pitch; // last analysis stage in metrics
 };
 
-static float clampFloat(float v, float lo, float hi)
+static KickParams baseFromTarget(const KickMetrics& target)
 {
-    return std::max(lo, std::min(v, hi));
+    // Rough estimates, brought into range by the schema clamp
+    KickParams p;
+    p.pitchStartHz = (float)target.pitch_start_hz;
+    p.pitchEndHz = (float)target.pitch_end_hz;
+    p.pitchTauMs = (float)target.pitch_tau_ms;
+    p.attackMs = (float)target.attack_ms;
+    p.t12Ms = (float)target.t12_ms;
+    p.t24Ms = (float)target.t24_ms;
+    p.tailMsToMinus60Db = (float)target.tail_ms_to_minus60db;
+    p.clickLevel = (float)(target.click_2k_10k_over_body_60_200 / 10.0);
+    p.bodyLevel = (float)(target.sub_20_60_over_body_60_200 / 50.0);
+    p.drive = (float)(target.crest_db / 20.0);
+    p.outputGainDb = (float)target.peak_dbfs;
+    return p.clamped();
 }
 
-static KickParams clampParams(KickParams p)
+// Scores one rendered candidate (clamped params) on the terms in termMask. The score is a sum of
+// non-negative terms, so the terms of the stages measured so far bound it from below: once that
+// bound exceeds rejectAbove the analysis stops and the candidate comes back incomplete, scored with
+// the bound. The analysis also stops, complete, once every stage the mask needs is measured.
+static Candidate analyseCandidate(const KickParams& params,
+                                  const juce::AudioBuffer<float>& buffer,
+                                  AnalysisWorkspace& workspace,
+                                  const KickMetrics& target,
+                                  double sampleRate,
+                                  double rejectAbove,
+                                  int termMask)
 {
-    p.bodyLevel = clampFloat(p.bodyLevel, 0.0f, 1.0f);
-    p.clickLevel = clampFloat(p.clickLevel, 0.0f, 1.0f);
-    p.pitchStartHz = clampFloat(p.pitchStartHz, 20.0f, 500.0f);
-    p.pitchEndHz = clampFloat(p.pitchEndHz, 20.0f, 200.0f);
-    p.pitchTauMs = clampFloat(p.pitchTauMs, 1.0f, 100.0f);
-    p.attackMs = clampFloat(p.attackMs, 0.0f, 50.0f);
-    p.t12Ms = clampFloat(p.t12Ms, 1.0f, 50.0f);
-    p.t24Ms = clampFloat(p.t24Ms, 5.0f, 200.0f);
-    p.tailMsToMinus60Db = clampFloat(p.tailMsToMinus60Db, 10.0f, 500.0f);
-    p.clickDecayMs = clampFloat(p.clickDecayMs, 1.0f, 20.0f);
-    p.clickHPFHz = clampFloat(p.clickHPFHz, 500.0f, 10000.0f);
-    p.bodyOscType = std::max(0, std::min(p.bodyOscType, 1));
-    p.keyTracking = clampFloat(p.keyTracking, -12.0f, 12.0f);
-    p.distortionType = std::max(0, std::min(p.distortionType, 2));
-    p.drive = clampFloat(p.drive, 0.0f, 1.0f);
-    p.asymmetry = clampFloat(p.asymmetry, 0.0f, 1.0f);
-    p.outputGainDb = clampFloat(p.outputGainDb, -12.0f, 12.0f);
-    p.outputHPFHz = clampFloat(p.outputHPFHz, 20.0f, 200.0f);
-    p.velocitySensitivity = clampFloat(p.velocitySensitivity, 0.0f, 1.0f);
-    return p;
-}
+    const auto requiredStage = getRequiredStage(termMask);
+    double partialScore = 0.0;
+    auto result = KickAnalyzer::analyzeBuffer(buffer, sampleRate, workspace, nullptr,
+        [&](KickAnalysisStage stage, const KickMetrics& partial)
+        {
+            partialScore = computeScore(target, partial, stage, termMask).score;
+            return partialScore > rejectAbove || stage >= requiredStage;
+        });
 
-static KickParams baseFromTarget(const KickMetrics& target)
-{
-    KickParams p;
-    p.pitchStartHz = clampFloat((float)target.pitch_start_hz, 20.0f, 500.0f);
-    p.pitchEndHz = clampFloat((float)target.pitch_end_hz, 20.0f, 200.0f);
-    p.pitchTauMs = clampFloat((float)target.pitch_tau_ms, 1.0f, 100.0f);
-    p.attackMs = clampFloat((float)target.attack_ms, 0.0f, 50.0f);
-    p.t12Ms = clampFloat((float)target.t12_ms, 1.0f, 50.0f);
-    p.t24Ms = clampFloat((float)target.t24_ms, 5.0f, 200.0f);
-    p.tailMsToMinus60Db = clampFloat((float)target.tail_ms_to_minus60db, 10.0f, 500.0f);
-    p.clickLevel = clampFloat((float)(target.click_2k_10k_over_body_60_200 / 10.0), 0.0f, 1.0f);
-    p.bodyLevel = clampFloat((float)(target.sub_20_60_over_body_60_200 / 50.0), 0.1f, 1.0f);
-    p.drive = clampFloat((float)(target.crest_db / 20.0), 0.0f, 1.0f);
-    p.outputGainDb = clampFloat((float)target.peak_dbfs, -12.0f, 12.0f);
-    return clampParams(p);
+    if (result.aborted)
+        return { params, result.metrics, partialScore, result.completedStage >= requiredStage, result.completedStage };
+
+    double score = computeScore(target, result.metrics, KickAnalysisStage::Pitch, termMask).score;
+    return { params, result.metrics, score, true, KickAnalysisStage::Pitch };
 }
 
+// Renders and scores one candidate (see analyseCandidate)
 static Candidate evaluateCandidate(const KickParams& rawParams,
                                    const KickMetrics& target,
                                    KickRenderEngine& engine,
                                    juce::AudioBuffer<float>& buffer,
-                                   double sampleRate)
+                                   AnalysisWorkspace& workspace,
+                                   double sampleRate,
+                                   double rejectAbove,
+                                   int termMask)
 {
-    KickParams params = clampParams(rawParams);
-
-    const double lengthMs = std::max(300.0, (double)params.tailMsToMinus60Db + 200.0);
-    const int numSamples = std::max(1, (int)std::round(sampleRate * (lengthMs / 1000.0)));
-    buffer.setSize(1, numSamples, false, false, true);
-
+    const KickParams params = rawParams.clamped();
+    buffer.setSize(1, KickRenderEngine::getRenderLength(params, sampleRate), false, false, true);
     engine.render(params, 1.0f, buffer);
-    auto result = KickAnalyzer::analyzeBuffer(buffer, sampleRate);
-    double score = computeScore(target, result.metrics).score;
-    return { params, result.metrics, score };
+    return analyseCandidate(params, buffer, workspace, target, sampleRate, rejectAbove, termMask);
 }
 
-static Candidate refineCoordinateDescent(const Candidate& start,
-                                        const KickMetrics& target,
-                                        KickRenderEngine& engine,
-                                        juce::AudioBuffer<float>& buffer,
-                                        double sampleRate,
-                                        int refineIters)
+// Scored renders keyed by their parameters. Fitted parameters are snapped to multiples of their
+// fitMinStep (counted from the range minimum) before rendering, so a key stands for exactly one
+// rendered parameter set; every other parameter is keyed on its exact value, and the rendered layer
+// mask completes the key. Entries keep the metrics of the stages they measured and are rescored by
+// the evaluator on every hit, so one entry serves any set of score terms its stages cover. The
+// cache file holds full-layer, fully analysed entries only, as parameters and metrics; scores are
+// recomputed against the current target when it is loaded, so a file can be reused by any run at the
+// same sample rate and parameter schema.
+class EvaluationCache
 {
-    Candidate best = start;
+public:
+    using Key = std::vector<int64_t>;
 
-    struct FloatParam
+    struct KeyHash
     {
-        const char* name = "";
-        float KickParams::* member = nullptr;
-        float lo = 0.0f;
-        float hi = 1.0f;
-        float step = 0.01f;
-        float minStep = 0.001f;
+        size_t operator()(const Key& key) const
+        {
+            uint64_t hash = 1469598103934665603ull; // FNV-1a over the key words
+            for (int64_t word : key)
+            {
+                hash ^= (uint64_t)word;
+                hash *= 1099511628211ull;
+            }
+            return (size_t)hash;
+        }
     };
 
-    std::vector<FloatParam> params = {
-        {"pitchStartHz", &KickParams::pitchStartHz, 20.0f, 500.0f, 20.0f, 1.0f},
-        {"pitchEndHz", &KickParams::pitchEndHz, 20.0f, 200.0f, 10.0f, 1.0f},
-        {"pitchTauMs", &KickParams::pitchTauMs, 1.0f, 100.0f, 5.0f, 0.25f},
-        {"attackMs", &KickParams::attackMs, 0.0f, 50.0f, 2.0f, 0.1f},
-        {"t12Ms", &KickParams::t12Ms, 1.0f, 50.0f, 2.0f, 0.1f},
-        {"t24Ms", &KickParams::t24Ms, 5.0f, 200.0f, 5.0f, 0.25f},
-        {"tailMsToMinus60Db", &KickParams::tailMsToMinus60Db, 10.0f, 500.0f, 20.0f, 1.0f},
-        {"bodyLevel", &KickParams::bodyLevel, 0.0f, 1.0f, 0.05f, 0.005f},
-        {"clickLevel", &KickParams::clickLevel, 0.0f, 1.0f, 0.05f, 0.005f},
-        {"clickDecayMs", &KickParams::clickDecayMs, 1.0f, 20.0f, 1.0f, 0.1f},
-        {"clickHPFHz", &KickParams::clickHPFHz, 500.0f, 10000.0f, 400.0f, 25.0f},
-        {"drive", &KickParams::drive, 0.0f, 1.0f, 0.05f, 0.005f},
-        {"asymmetry", &KickParams::asymmetry, 0.0f, 1.0f, 0.05f, 0.005f},
-        {"outputGainDb", &KickParams::outputGainDb, -12.0f, 12.0f, 1.0f, 0.1f},
-        {"outputHPFHz", &KickParams::outputHPFHz, 20.0f, 200.0f, 10.0f, 1.0f},
-        {"velocitySensitivity", &KickParams::velocitySensitivity, 0.0f, 1.0f, 0.05f, 0.005f},
+    static constexpr int fileFormatVersion = 2; // 2: pitch metrics from the decimated analyser
+
+    static KickParams quantise(const KickParams& params)
+    {
+        KickParams q = params.clamped();
+        for (int index = 0; index < KickParameterSchema::numParameters; ++index)
+        {
+            const auto& spec = KickParameterSchema::specs[(size_t)index];
+            if (!spec.isFitted())
+                continue;
+
+            const double steps = std::round((q.get(index) - spec.minValue) / (double)spec.fitMinStep);
+            q.set(index, juce::jlimit(spec.minValue, spec.maxValue, (float)(spec.minValue + steps * spec.fitMinStep)));
+        }
+        return q;
+    }
+
+    static Key makeKey(const KickParams& quantised, int layerMask)
+    {
+        Key key;
+        key.reserve((size_t)KickParameterSchema::numParameters + 2);
+        for (int index = 0; index < KickParameterSchema::numParameters; ++index)
+        {
+            const auto& spec = KickParameterSchema::specs[(size_t)index];
+            const float value = quantised.get(index);
+            if (spec.isFitted())
+            {
+                key.push_back((int64_t)std::llround((value - spec.minValue) / (double)spec.fitMinStep));
+            }
+            else
+            {
+                uint32_t bits = 0;
+                std::memcpy(&bits, &value, sizeof(bits));
+                key.push_back((int64_t)bits);
+            }
+        }
+        key.push_back(quantised.noiseSeed);
+        key.push_back(layerMask);
+        return key;
+    }
+
+    const Candidate* find(const Key& key) const
+    {
+        auto it = entries.find(key);
+        return it != entries.end() ? &it->second.candidate : nullptr;
+    }
+
+    bool isFromFile(const Key& key) const
+    {
+        auto it = entries.find(key);
+        return it != entries.end() && it->second.fromFile;
+    }
+
+    void insert(const Key& key, const Candidate& candidate)
+    {
+        entries[key] = { candidate, false };
+    }
+
+    int size() const { return (int)entries.size(); }
+
+    // Adds the entries of a cache file; returns false if it is missing or was written for another
+    // sample rate or parameter schema
+    bool load(const juce::File& file, const KickMetrics& target, double sampleRate)
+    {
+        if (!file.existsAsFile())
+            return false;
+
+        auto json = juce::JSON::parse(file.loadFileAsString());
+        if ((int)json.getProperty("format", 0) != fileFormatVersion
+            || (double)json.getProperty("sampleRate", 0.0) != sampleRate
+            || json.getProperty("schema", "").toString() != KickParams::getSchemaSignature())
+            return false;
+
+        if (auto* list = json.getProperty("entries", juce::var()).getArray())
+        {
+            for (const auto& entry : *list)
+            {
+                Candidate cand;
+                cand.params = quantise(KickParams::fromJson(entry.getProperty("params", juce::var())));
+                cand.metrics = KickMetrics::fromJson(entry.getProperty("metrics", juce::var()));
+                cand.score = computeScore(target, cand.metrics).score;
+                entries[makeKey(cand.params, KickRenderEngine::allLayers)] = { cand, true };
+            }
+        }
+        return true;
+    }
+
+    bool save(const juce::File& file, double sampleRate) const
+    {
+        juce::String text;
+        text << "{\"format\": " << fileFormatVersion
+             << ", \"sampleRate\": " << sampleRate
+             << ", \"schema\": " << juce::JSON::toString(KickParams::getSchemaSignature())
+             << ", \"entries\": [\n";
+
+        bool first = true;
+        for (const auto& entry : entries)
+        {
+            if (entry.second.candidate.measuredStage != KickAnalysisStage::Pitch
+                || entry.first.back() != KickRenderEngine::allLayers)
+                continue; // partial metrics or a layer render
+
+            if (!first)
+                text << ",\n";
+            text << "{\"params\": " << entry.second.candidate.params.toJson()
+                 << ", \"metrics\": " << entry.second.candidate.metrics.toJson() << "}";
+            first = false;
+        }
+        text << "\n]}\n";
+
+        return file.replaceWithText(text);
+    }
+
+private:
+    struct Entry
+    {
+        Candidate candidate;
+        bool fromFile = false;
     };
 
-    for (int iter = 0; iter < refineIters; ++iter)
+    std::unordered_map<Key, Entry, KeyHash> entries;
+};
+
+// Evaluates batches of candidates on one render engine and buffer per worker. Workers pull
+// candidates from a shared counter and write the results back by index, so a batch always returns
+// in input order and its scores do not depend on the number of jobs (every render starts from a
+// reset chain). Candidates are quantised and looked up in an EvaluationCache first; only misses
+// are rendered, each distinct one once per batch. Every render is counted, in batch order, together
+// with the best full score so far, so optimisers can be compared by the renders they need to reach a
+// score. setScoring narrows the evaluation to some layers and score terms, for fitting one aspect of
+// the sound at a time. setNumLanes renders several candidates per pass (KickBatchRenderEngine).
+class CandidateEvaluator
+{
+public:
+    CandidateEvaluator(const KickMetrics& targetMetrics, double rate, int numJobs)
+        : target(targetMetrics), sampleRate(rate)
     {
-        bool improved = false;
+        numJobs = std::max(1, numJobs);
+        for (int job = 0; job < numJobs; ++job)
+        {
+            workers.push_back(std::make_unique<Worker>());
+            workers.back()->engine.prepare(sampleRate);
+            workers.back()->engine.setSkipSilentTail(true);
+            workers.back()->batchEngine.prepare(sampleRate);
+            workers.back()->batchEngine.setSkipSilentTail(true);
+        }
 
-        for (auto& spec : params)
+        // The calling thread works too, so the pool only needs the remaining workers
+        if (numJobs > 1)
+            pool = std::make_unique<juce::ThreadPool>(numJobs - 1);
+    }
+
+    int getNumJobs() const { return (int)workers.size(); }
+    double getSampleRate() const { return sampleRate; }
+    int getNumLanes() const { return numLanes; }
+    int getNumRenders() const { return numRenders; }
+    EvaluationCache& getCache() { return cache; }
+
+    // With early rejection off every candidate is analysed completely, whatever rejectAbove is
+    void setEarlyRejection(bool shouldReject) { earlyRejection = shouldReject; }
+
+    // With more than one lane each worker renders up to that many candidates per pass on a
+    // KickBatchRenderEngine; the renders, and so the scores, are the same as one at a time
+    void setNumLanes(int newNumLanes) { numLanes = juce::jlimit(1, KickBatchRenderEngine::numLanes, newNumLanes); }
+
+    // Where the optimisers running on this evaluator report their progress (std::cout by default)
+    void setLog(std::ostream& stream) { log = &stream; }
+    std::ostream& getLog() { return *log; }
+
+    // Renders only the layers in layerMask (KickRenderEngine::Layer) and scores only the terms in
+    // termMask (KickScoreTerms); the analysis stops after the last stage those terms need
+    void setScoring(int newLayerMask, int newTermMask)
+    {
+        layerMask = newLayerMask;
+        termMask = newTermMask;
+        for (auto& worker : workers)
         {
-            const float center = best.params.*(spec.member);
+            worker->engine.setLayerMask(layerMask);
+            worker->batchEngine.setLayerMask(layerMask);
+        }
+    }
 
-            KickParams testMinus = best.params;
-            testMinus.*(spec.member) = clampFloat(center - spec.step, spec.lo, spec.hi);
-            auto candMinus = evaluateCandidate(testMinus, target, engine, buffer, sampleRate);
+    bool isScoringEverything() const
+    {
+        return layerMask == KickRenderEngine::allLayers && termMask == allScoreTerms;
+    }
+
+    // Renders needed until the best score first reached score, or -1 if it never did
+    int getRendersToReach(double score) const
+    {
+        for (const auto& improvement : improvements)
+            if (improvement.second <= score)
+                return improvement.first;
+        return -1;
+    }
+
+    // Candidates that provably score above rejectAbove are returned incomplete, with a lower bound
+    // for their score. The threshold is fixed for the whole batch, so which candidates are rejected
+    // does not depend on the job count.
+    std::vector<Candidate> evaluate(const std::vector<KickParams>& batch,
+                                    double rejectAbove = std::numeric_limits<double>::infinity())
+    {
+        if (!earlyRejection)
+            rejectAbove = std::numeric_limits<double>::infinity();
 
-            KickParams testPlus = best.params;
-            testPlus.*(spec.member) = clampFloat(center + spec.step, spec.lo, spec.hi);
-            auto candPlus = evaluateCandidate(testPlus, target, engine, buffer, sampleRate);
+        std::vector<Candidate> results(batch.size());
+        std::vector<int> missIndex(batch.size(), -1);
+        std::vector<KickParams> misses;
+        std::vector<EvaluationCache::Key> missKeys;
+        std::unordered_map<EvaluationCache::Key, int, EvaluationCache::KeyHash> pending;
 
-            if (candMinus.score < best.score && candMinus.score <= candPlus.score)
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+            const auto params = EvaluationCache::quantise(batch[i]);
+            auto key = EvaluationCache::makeKey(params, layerMask);
+            ++numLookups;
+
+            // An entry whose stages do not cover the scored terms only answers for thresholds its
+            // partial score is known to exceed
+            if (auto* cached = cache.find(key))
+            {
+                Candidate rescored = *cached;
+                rescored.score = computeScore(target, rescored.metrics, rescored.measuredStage, termMask).score;
+                rescored.complete = rescored.measuredStage >= getRequiredStage(termMask);
+                if (rescored.complete || rescored.score > rejectAbove)
+                {
+                    results[i] = std::move(rescored);
+                    ++numHits;
+                    if (cache.isFromFile(key))
+                        ++numFileHits;
+                    continue;
+                }
+            }
+
+            auto inserted = pending.emplace(key, (int)misses.size());
+            if (inserted.second)
+            {
+                misses.push_back(params);
+                missKeys.push_back(std::move(key));
+            }
+            else
             {
-                best = std::move(candMinus);
-                improved = true;
+                ++numHits; // repeated within the batch
             }
-            else if (candPlus.score < best.score)
+            missIndex[i] = inserted.first->second;
+        }
+
+        auto rendered = evaluateBatch(misses, rejectAbove);
+        for (size_t k = 0; k < rendered.size(); ++k)
+            cache.insert(missKeys[k], rendered[k]);
+
+        std::vector<bool> counted(rendered.size(), false);
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+            if (missIndex[i] >= 0)
             {
-                best = std::move(candPlus);
-                improved = true;
+                results[i] = rendered[(size_t)missIndex[i]];
+                if (!counted[(size_t)missIndex[i]])
+                {
+                    counted[(size_t)missIndex[i]] = true;
+                    ++numRenders;
+                    if (!results[i].complete)
+                        ++numRejected;
+                }
             }
+
+            if (isScoringEverything() && (improvements.empty() || results[i].score < improvements.back().second))
+                improvements.emplace_back(numRenders, results[i].score);
+        }
+        return results;
+    }
+
+    void printEvaluationReport() const
+    {
+        const double hitRate = numLookups > 0 ? 100.0 * numHits / numLookups : 0.0;
+        std::cout << "Evaluation cache: " << numLookups << " lookups, " << numHits << " hits ("
+                  << std::fixed << std::setprecision(1) << hitRate << "%, " << numFileHits << " from file), "
+                  << numRenders << " renders, " << cache.size() << " entries\n";
+        std::cout << "Early rejection: " << numRejected << " of " << numRenders
+                  << " renders stopped before full analysis\n";
+    }
+
+private:
+    std::vector<Candidate> evaluateBatch(const std::vector<KickParams>& batch, double rejectAbove)
+    {
+        std::vector<Candidate> results(batch.size());
+        std::atomic<size_t> nextIndex { 0 };
+
+        if (numLanes <= 1)
+        {
+            runOnWorkers(pool.get(), std::min(getNumJobs(), (int)batch.size()), [&](int w)
+            {
+                auto& worker = *workers[(size_t)w];
+                for (size_t i = nextIndex++; i < batch.size(); i = nextIndex++)
+                    results[i] = evaluateCandidate(batch[i], target, worker.engine, worker.buffer, worker.analysis,
+                                                   sampleRate, rejectAbove, termMask);
+            });
+            return results;
+        }
+
+        // With lanes, workers pull whole passes instead of single candidates
+        std::vector<KickParams> clamped;
+        for (const auto& params : batch)
+            clamped.push_back(params.clamped());
+        const auto passes = KickBatchRenderEngine::makeBatches(clamped, numLanes);
+
+        runOnWorkers(pool.get(), std::min(getNumJobs(), (int)passes.size()), [&](int w)
+        {
+            auto& worker = *workers[(size_t)w];
+            for (size_t p = nextIndex++; p < passes.size(); p = nextIndex++)
+            {
+                const auto& pass = passes[p];
+                std::array<KickParams, KickBatchRenderEngine::numLanes> laneParams;
+                std::array<juce::AudioBuffer<float>*, KickBatchRenderEngine::numLanes> laneBuffers {};
+                for (size_t lane = 0; lane < pass.size(); ++lane)
+                {
+                    laneParams[lane] = clamped[(size_t)pass[lane]];
+                    worker.laneBuffers[lane].setSize(1, KickRenderEngine::getRenderLength(laneParams[lane], sampleRate),
+                                                     false, false, true);
+                    laneBuffers[lane] = &worker.laneBuffers[lane];
+                }
+
+                worker.batchEngine.render(laneParams.data(), (int)pass.size(), 1.0f, laneBuffers.data());
+                for (size_t lane = 0; lane < pass.size(); ++lane)
+                    results[(size_t)pass[lane]] = analyseCandidate(laneParams[lane], worker.laneBuffers[lane], worker.analysis,
+                                                                   target, sampleRate, rejectAbove, termMask);
+            }
+        });
+        return results;
+    }
+
+    struct Worker
+    {
+        KickRenderEngine engine;
+        juce::AudioBuffer<float> buffer;
+        AnalysisWorkspace analysis;
+        KickBatchRenderEngine batchEngine;
+        std::array<juce::AudioBuffer<float>, KickBatchRenderEngine::numLanes> laneBuffers;
+    };
+
+    const KickMetrics& target;
+    double sampleRate = 48000.0;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::unique_ptr<juce::ThreadPool> pool;
+
+    EvaluationCache cache;
+    int numLookups = 0;
+    int numHits = 0;
+    int numFileHits = 0;
+    int numRenders = 0;
+    int numRejected = 0;
+    bool earlyRejection = true;
+    int numLanes = 1;
+    std::ostream* log = &std::cout;
+    int layerMask = KickRenderEngine::allLayers;
+    int termMask = allScoreTerms;
+    std::vector<std::pair<int, double>> improvements; // (renders so far, new best score)
+};
+
+// Continuous parameters with a fit step in the schema, in schema order
+struct FloatParam
+{
+    int index = 0;
+    float lo = 0.0f;
+    float hi = 1.0f;
+    float step = 0.01f;
+    float minStep = 0.001f;
+};
+
+static std::vector<FloatParam> getFittedFloatParams()
+{
+    std::vector<FloatParam> params;
+    for (int index = 0; index < KickParameterSchema::numParameters; ++index)
+    {
+        const auto& spec = KickParameterSchema::specs[(size_t)index];
+        if (spec.isFitted())
+            params.push_back({ index, spec.minValue, spec.maxValue, spec.fitStep, spec.fitMinStep });
+    }
+    return params;
+}
+
+// Discrete sweep for oscillator / distortion types (every choice in the schema).
+static Candidate sweepDiscreteTypes(const Candidate& start, CandidateEvaluator& evaluator)
+{
+    const int maxOscType = (int)KickParameterSchema::specs[KickParameterSchema::bodyOscType].maxValue;
+    const int maxDistortionType = (int)KickParameterSchema::specs[KickParameterSchema::distortionType].maxValue;
+
+    std::vector<KickParams> probes;
+    for (int osc = 0; osc <= maxOscType; ++osc)
+    {
+        for (int dist = 0; dist <= maxDistortionType; ++dist)
+        {
+            KickParams p = start.params;
+            p.bodyOscType = osc;
+            p.distortionType = dist;
+            probes.push_back(p);
+        }
+    }
+
+    Candidate bestDiscrete = start;
+    for (auto& cand : evaluator.evaluate(probes, start.score))
+        if (cand.score < bestDiscrete.score)
+            bestDiscrete = std::move(cand);
+
+    return bestDiscrete;
+}
+
+static Candidate refineCoordinateDescent(const Candidate& start,
+                                        CandidateEvaluator& evaluator,
+                                        int refineIters)
+{
+    Candidate best = start;
+    auto params = getFittedFloatParams();
+
+    // The +- probes of several parameters are evaluated together from the current best. Once one of
+    // them is accepted the probes after it are stale and get re-evaluated from the new best, so the
+    // accepted steps are exactly those of a one-parameter-at-a-time sweep whatever the job count.
+    // The stale probes were still rendered and count as renders, so the render report of a
+    // coordinate run grows with the job count even though its result does not.
+    const size_t paramsPerBatch = (size_t)std::max(1, evaluator.getNumJobs() / 2);
+    std::vector<KickParams> probes;
+
+    for (int iter = 0; iter < refineIters; ++iter)
+    {
+        bool improved = false;
+
+        size_t first = 0;
+        while (first < params.size())
+        {
+            const size_t end = std::min(params.size(), first + paramsPerBatch);
+            probes.clear();
+            for (size_t k = first; k < end; ++k)
+            {
+                const auto& spec = params[k];
+                const float center = best.params.get(spec.index);
+
+                KickParams testMinus = best.params;
+                testMinus.set(spec.index, juce::jlimit(spec.lo, spec.hi, center - spec.step));
+                probes.push_back(testMinus);
+
+                KickParams testPlus = best.params;
+                testPlus.set(spec.index, juce::jlimit(spec.lo, spec.hi, center + spec.step));
+                probes.push_back(testPlus);
+            }
+
+            auto results = evaluator.evaluate(probes, best.score);
+
+            size_t next = end;
+            for (size_t k = first; k < end; ++k)
+            {
+                auto& candMinus = results[2 * (k - first)];
+                auto& candPlus = results[2 * (k - first) + 1];
+
+                bool accepted = false;
+                if (candMinus.score < best.score && candMinus.score <= candPlus.score)
+                {
+                    best = std::move(candMinus);
+                    accepted = true;
+                }
+                else if (candPlus.score < best.score)
+                {
+                    best = std::move(candPlus);
+                    accepted = true;
+                }
+
+                if (accepted)
+                {
+                    improved = true;
+                    next = k + 1;
+                    break;
+                }
+            }
+
+            first = next;
         }
 
         if (improved)
@@ -163,22 +613,519 @@ static Candidate refineCoordinateDescent(const Candidate& start,
             break;
     }
 
-    // Discrete sweep for oscillator / distortion types.
-    Candidate bestDiscrete = best;
-    for (int osc = 0; osc <= 1; ++osc)
+    return sweepDiscreteTypes(best, evaluator);
+}
+
+// CMA-ES over the given parameters, normalised to [0, 1] by their schema range, plus one dimension
+// per discrete type (the unit interval split into equal bins, one per choice); every other parameter
+// stays at its start value. Samples outside the box are clamped for rendering and pay a quadratic
+// penalty on the distance, so the distribution is pulled back inside. Restarts follow IPOP: on
+// convergence the population doubles and the search starts again around the best point so far with
+// twice the initial step, until the evaluator has made renderBudget renders in total. start must be scored
+// the way the evaluator currently scores.
+static Candidate refineCmaEs(const Candidate& start,
+                             CandidateEvaluator& evaluator,
+                             const std::vector<FloatParam>& params,
+                             const std::vector<int>& discreteIndices,
+                             int renderBudget,
+                             uint32_t seed,
+                             double initialSigma = 0.15)
+{
+    constexpr double boundaryPenalty = 10.0;
+
+    const size_t numDimensions = params.size() + discreteIndices.size();
+
+    auto encode = [&](const KickParams& p)
     {
-        for (int dist = 0; dist <= 2; ++dist)
+        std::vector<double> x(numDimensions);
+        for (size_t k = 0; k < params.size(); ++k)
+            x[k] = (p.get(params[k].index) - params[k].lo) / (double)(params[k].hi - params[k].lo);
+        for (size_t k = 0; k < discreteIndices.size(); ++k)
         {
-            KickParams p = best.params;
-            p.bodyOscType = osc;
-            p.distortionType = dist;
-            auto cand = evaluateCandidate(p, target, engine, buffer, sampleRate);
-            if (cand.score < bestDiscrete.score)
-                bestDiscrete = std::move(cand);
+            const double numChoices = KickParameterSchema::specs[(size_t)discreteIndices[k]].maxValue + 1.0;
+            x[params.size() + k] = (p.get(discreteIndices[k]) + 0.5) / numChoices;
+        }
+        return x;
+    };
+
+    auto decode = [&](const std::vector<double>& x)
+    {
+        KickParams p = start.params;
+        for (size_t k = 0; k < params.size(); ++k)
+            p.set(params[k].index, params[k].lo + (float)juce::jlimit(0.0, 1.0, x[k]) * (params[k].hi - params[k].lo));
+        for (size_t k = 0; k < discreteIndices.size(); ++k)
+        {
+            const int numChoices = (int)KickParameterSchema::specs[(size_t)discreteIndices[k]].maxValue + 1;
+            const int choice = (int)std::floor(juce::jlimit(0.0, 1.0, x[params.size() + k]) * numChoices);
+            p.set(discreteIndices[k], (float)std::min(choice, numChoices - 1));
+        }
+        return p;
+    };
+
+    Candidate best = start;
+    int populationSize = 0;
+    double sigma = initialSigma;
+    std::vector<KickParams> population;
+    std::vector<double> fitness, sortedFitness;
+
+    for (int restart = 0; evaluator.getNumRenders() < renderBudget; ++restart)
+    {
+        CmaEs cma(encode(best.params), sigma, populationSize, seed + (uint32_t)restart);
+        populationSize = cma.getPopulationSize();
+        double rejectAbove = std::numeric_limits<double>::infinity();
+
+        evaluator.getLog() << "  CMA-ES run " << (restart + 1) << ": population " << populationSize
+                  << ", sigma " << sigma << "\n";
+
+        while (!cma.hasConverged() && evaluator.getNumRenders() + populationSize <= renderBudget)
+        {
+            const auto& samples = cma.ask();
+
+            population.clear();
+            for (const auto& x : samples)
+                population.push_back(decode(x));
+
+            auto results = evaluator.evaluate(population, rejectAbove);
+
+            auto computeFitness = [&]()
+            {
+                int numBelowCut = 0;
+                for (size_t i = 0; i < samples.size(); ++i)
+                {
+                    double outside = 0.0;
+                    for (double v : samples[i])
+                    {
+                        const double excess = v - juce::jlimit(0.0, 1.0, v);
+                        outside += excess * excess;
+                    }
+                    fitness[i] = results[i].score + boundaryPenalty * outside;
+                    if (results[i].complete && fitness[i] <= rejectAbove)
+                        ++numBelowCut;
+                }
+                return numBelowCut;
+            };
+
+            // Rejected candidates are only known to lie above the cut. As long as the better half
+            // (the part recombination uses) is complete and below it, the selection is exact;
+            // otherwise the rejected ones are analysed in full
+            fitness.resize(samples.size());
+            if (computeFitness() < populationSize / 2)
+            {
+                std::vector<KickParams> rejected;
+                std::vector<size_t> rejectedIndices;
+                for (size_t i = 0; i < results.size(); ++i)
+                {
+                    if (!results[i].complete)
+                    {
+                        rejected.push_back(population[i]);
+                        rejectedIndices.push_back(i);
+                    }
+                }
+
+                auto exact = evaluator.evaluate(rejected);
+                for (size_t k = 0; k < exact.size(); ++k)
+                    results[rejectedIndices[k]] = std::move(exact[k]);
+                computeFitness();
+            }
+
+            for (auto& result : results)
+                if (result.score < best.score)
+                    best = std::move(result);
+
+            cma.tell(fitness);
+
+            // The next generation only needs exact scores below this one's selection cut
+            sortedFitness = fitness;
+            std::nth_element(sortedFitness.begin(), sortedFitness.begin() + (populationSize / 2 - 1), sortedFitness.end());
+            rejectAbove = sortedFitness[(size_t)(populationSize / 2 - 1)];
         }
+
+        if (cma.getGeneration() == 0)
+            break; // not enough budget left for a single generation
+
+        populationSize *= 2;
+        sigma = 2.0 * initialSigma;
     }
 
-    return bestDiscrete;
+    return best;
+}
+
+// Hierarchical fit: the pitch envelope is fitted first on the body layer alone, against the pitch
+// terms only, then the amplitude envelope against the envelope terms, then click, drive and levels
+// against the band ratios and peak / RMS / crest. Each pass searches a few dimensions with CMA-ES on
+// a budget proportional to its size, so the problems the full search couples (the click skewing the
+// pitch track, the drive moving the decay times) are solved one at a time. A short joint polish over
+// every dimension with a small step and the discrete sweep repair the coupling the passes ignore.
+static Candidate refineStaged(const Candidate& start,
+                              CandidateEvaluator& evaluator,
+                              int renderBudget,
+                              uint32_t seed)
+{
+    constexpr int rendersPerDimension = 40;
+    constexpr int polishRendersPerDimension = 20;
+    constexpr double polishSigma = 0.05;
+
+    namespace Schema = KickParameterSchema;
+    struct Pass
+    {
+        const char* name;
+        std::vector<int> indices;
+        int layerMask;
+        int termMask;
+    };
+    const Pass passes[] = {
+        { "pitch", { Schema::pitchStartHz, Schema::pitchEndHz, Schema::pitchTauMs },
+          KickRenderEngine::bodyLayer, pitchScoreTerms },
+        { "envelope", { Schema::attackMs, Schema::t12Ms, Schema::t24Ms, Schema::tailMsToMinus60Db },
+          KickRenderEngine::allLayers, envelopeScoreTerms },
+        { "balance", { Schema::bodyLevel, Schema::clickLevel, Schema::clickDecayMs, Schema::clickHPFHz,
+                       Schema::drive, Schema::asymmetry, Schema::outputGainDb, Schema::outputHPFHz },
+          KickRenderEngine::allLayers, levelScoreTerms | spectralScoreTerms }
+    };
+
+    const auto fitted = getFittedFloatParams();
+    KickParams current = start.params;
+
+    for (size_t p = 0; p < std::size(passes); ++p)
+    {
+        const auto& pass = passes[p];
+        std::vector<FloatParam> params;
+        for (const auto& spec : fitted)
+            if (std::find(pass.indices.begin(), pass.indices.end(), spec.index) != pass.indices.end())
+                params.push_back(spec);
+
+        const int passBudget = std::min(renderBudget,
+                                        evaluator.getNumRenders() + rendersPerDimension * (int)params.size());
+
+        evaluator.setScoring(pass.layerMask, pass.termMask);
+        const Candidate passStart = evaluator.evaluate({ current }).front();
+        const Candidate passBest = refineCmaEs(passStart, evaluator, params, {}, passBudget, seed + 1000u * (uint32_t)(p + 1));
+        current = passBest.params;
+
+        evaluator.setScoring(KickRenderEngine::allLayers, allScoreTerms);
+        const double fullScore = evaluator.evaluate({ current }).front().score;
+        evaluator.getLog() << "  " << pass.name << " pass: " << params.size() << " parameters, pass score "
+                  << std::fixed << std::setprecision(3) << passStart.score << " -> " << passBest.score
+                  << ", full score " << fullScore << " (" << evaluator.getNumRenders() << " renders)\n";
+    }
+
+    // The passes only ever lower their own terms, so keep the start if they cost more elsewhere
+    Candidate best = evaluator.evaluate({ current }).front();
+    if (start.score < best.score)
+        best = start;
+
+    const std::vector<int> discreteIndices = { Schema::bodyOscType, Schema::distortionType };
+    const int numDimensions = (int)(fitted.size() + discreteIndices.size());
+    const int polishBudget = std::min(renderBudget, evaluator.getNumRenders() + polishRendersPerDimension * numDimensions);
+    best = refineCmaEs(best, evaluator, fitted, discreteIndices, polishBudget, seed, polishSigma);
+    evaluator.getLog() << "  polish: full score " << std::fixed << std::setprecision(3) << best.score
+              << " (" << evaluator.getNumRenders() << " renders)\n";
+
+    return sweepDiscreteTypes(best, evaluator);
+}
+
+// Solves a * x = b for a small symmetric positive definite a (Cholesky); false if a is not
+static bool solveSymmetric(std::vector<std::vector<double>> a, std::vector<double> b, std::vector<double>& x)
+{
+    const size_t n = b.size();
+    for (size_t j = 0; j < n; ++j)
+    {
+        double diagonal = a[j][j];
+        for (size_t k = 0; k < j; ++k)
+            diagonal -= a[j][k] * a[j][k];
+        if (diagonal <= 0.0)
+            return false;
+        a[j][j] = std::sqrt(diagonal);
+
+        for (size_t i = j + 1; i < n; ++i)
+        {
+            double sum = a[i][j];
+            for (size_t k = 0; k < j; ++k)
+                sum -= a[i][k] * a[j][k];
+            a[i][j] = sum / a[j][j];
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t k = 0; k < i; ++k)
+            b[i] -= a[i][k] * b[k];
+        b[i] /= a[i][i];
+    }
+    for (size_t i = n; i-- > 0;)
+    {
+        for (size_t k = i + 1; k < n; ++k)
+            b[i] -= a[k][i] * b[k];
+        b[i] /= a[i][i];
+    }
+
+    x = std::move(b);
+    return true;
+}
+
+// Levenberg-Marquardt over the parameters KickGradientModel differentiates, normalised to [0, 1]
+// by their schema range. Each iteration takes the score-term residuals from the real render of the
+// current best and their Jacobian from one pass of the model, reweights the terms so the least-
+// squares step follows the score's absolute errors (iteratively reweighted least squares), and
+// renders the step for a few damping factors at once; the best render that beats the current score
+// is accepted and the damping follows the factor that won. The damping is added in normalised
+// units rather than scaled by the diagonal, so parameters the metrics barely see (click decay,
+// the decay breakpoints early in a bright kick) take small steps instead of range-wide ones. The model only steers: every accepted
+// point is scored by a real render, so model error costs renders, never accuracy.
+static Candidate refineGradient(const Candidate& start,
+                                CandidateEvaluator& evaluator,
+                                const KickMetrics& target,
+                                double sampleRate,
+                                int renderBudget)
+{
+    constexpr std::array<double, 4> dampingFactors = { 0.3, 1.0, 3.0, 10.0 };
+    constexpr double initialDamping = 1.0;
+    constexpr double maxDamping = 1.0e6;
+    constexpr double minError = 0.1; // reweighting floor, in score units per unit weight
+    constexpr int numParameters = KickGradientModel::numParameters;
+
+    KickGradientModel model(sampleRate);
+    Candidate best = start.complete ? start : evaluator.evaluate({ start.params }).front();
+    double damping = initialDamping;
+    int iteration = 0;
+
+    while (damping < maxDamping && evaluator.getNumRenders() + (int)dampingFactors.size() <= renderBudget)
+    {
+        ++iteration;
+        const auto gradient = model.evaluate(best.params);
+        const auto terms = getScoreTerms(target, best.metrics);
+
+        // Weighted residuals and their Jacobian in normalised parameter units
+        std::vector<double> residuals;
+        std::vector<std::array<double, numParameters>> jacobian;
+        for (size_t i = 0; i < terms.size(); ++i)
+        {
+            const auto& term = terms[i];
+            const double error = (term.actual - term.target) / term.scale;
+            const double weight = std::sqrt(term.weight / std::max(std::abs(error), minError));
+            residuals.push_back(weight * error);
+
+            std::array<double, numParameters> row {};
+            for (int j = 0; j < numParameters; ++j)
+            {
+                const auto& spec = KickParameterSchema::specs[(size_t)KickGradientModel::parameters[(size_t)j]];
+                const double derivative = getScoreTerms(target, gradient.derivatives[(size_t)j])[i].actual;
+                row[(size_t)j] = weight * derivative * (spec.maxValue - spec.minValue) / term.scale;
+            }
+            jacobian.push_back(row);
+        }
+
+        std::vector<std::vector<double>> normal((size_t)numParameters, std::vector<double>((size_t)numParameters, 0.0));
+        std::vector<double> descent((size_t)numParameters, 0.0);
+        for (size_t i = 0; i < residuals.size(); ++i)
+        {
+            for (int j = 0; j < numParameters; ++j)
+            {
+                descent[(size_t)j] -= jacobian[i][(size_t)j] * residuals[i];
+                for (int k = 0; k < numParameters; ++k)
+                    normal[(size_t)j][(size_t)k] += jacobian[i][(size_t)j] * jacobian[i][(size_t)k];
+            }
+        }
+
+        std::vector<KickParams> steps;
+        std::vector<double> stepDamping;
+        for (double factor : dampingFactors)
+        {
+            const double lambda = damping * factor;
+            auto damped = normal;
+            for (int j = 0; j < numParameters; ++j)
+                damped[(size_t)j][(size_t)j] += lambda;
+
+            std::vector<double> delta;
+            if (!solveSymmetric(damped, descent, delta))
+                continue;
+
+            KickParams next = best.params;
+            for (int j = 0; j < numParameters; ++j)
+            {
+                const int index = KickGradientModel::parameters[(size_t)j];
+                const auto& spec = KickParameterSchema::specs[(size_t)index];
+                const double value = next.get(index) + delta[(size_t)j] * (spec.maxValue - spec.minValue);
+                next.set(index, (float)juce::jlimit((double)spec.minValue, (double)spec.maxValue, value));
+            }
+            steps.push_back(next);
+            stepDamping.push_back(lambda);
+        }
+
+        auto results = evaluator.evaluate(steps, best.score);
+        int accepted = -1;
+        for (size_t k = 0; k < results.size(); ++k)
+            if (results[k].complete && results[k].score < best.score
+                && (accepted < 0 || results[k].score < results[(size_t)accepted].score))
+                accepted = (int)k;
+
+        if (accepted >= 0)
+        {
+            best = std::move(results[(size_t)accepted]);
+            damping = stepDamping[(size_t)accepted];
+        }
+        else
+        {
+            damping *= 10.0;
+        }
+    }
+
+    evaluator.getLog() << "  Levenberg-Marquardt: " << iteration << " iterations (one model pass each)\n";
+    return best;
+}
+
+// Refines start with the named optimiser (coordinate, cmaes, staged or gradient), announcing it on
+// the evaluator's log; coordinate descent runs refineIters sweeps
+static Candidate refineCandidate(const Candidate& start,
+                                 CandidateEvaluator& evaluator,
+                                 const KickMetrics& target,
+                                 const juce::String& optimizer,
+                                 int renderBudget,
+                                 int refineIters,
+                                 uint32_t seed)
+{
+    auto& log = evaluator.getLog();
+    if (optimizer == "cmaes")
+    {
+        log << "\nRefining best candidate with CMA-ES (budget " << renderBudget << " renders)...\n";
+        const std::vector<int> discreteIndices = { KickParameterSchema::bodyOscType, KickParameterSchema::distortionType };
+        auto refined = refineCmaEs(start, evaluator, getFittedFloatParams(), discreteIndices, renderBudget, seed);
+        return sweepDiscreteTypes(refined, evaluator);
+    }
+    if (optimizer == "staged")
+    {
+        log << "\nRefining best candidate in stages: pitch, envelope, balance, polish (budget "
+            << renderBudget << " renders)...\n";
+        return refineStaged(start, evaluator, renderBudget, seed);
+    }
+    if (optimizer == "gradient")
+    {
+        log << "\nRefining best candidate with Levenberg-Marquardt on model gradients (budget "
+            << renderBudget << " renders)...\n";
+        auto refined = refineGradient(start, evaluator, target, evaluator.getSampleRate(), renderBudget);
+        return sweepDiscreteTypes(refined, evaluator);
+    }
+
+    log << "\nRefining best candidate (" << refineIters << " iters)...\n";
+    return refineCoordinateDescent(start, evaluator, refineIters);
+}
+
+// Renders counted by the evaluator, including speculative probes: coordinate descent with --jobs > 1
+// renders probes a serial sweep would have skipped, so compare optimisers at the same job count
+static void printRenderReport(const char* optimizerName,
+                              const CandidateEvaluator& evaluator,
+                              double bestScore,
+                              const std::vector<double>& reportScores)
+{
+    std::cout << "\n" << optimizerName << ": " << evaluator.getNumRenders() << " renders, best score "
+              << std::fixed << std::setprecision(3) << bestScore
+              << " after " << evaluator.getRendersToReach(bestScore) << " renders\n";
+
+    // Without explicit scores, report how quickly the run got within 10% and 1% of its best
+    std::vector<double> scores = reportScores;
+    if (scores.empty())
+        scores = { bestScore * 1.1, bestScore * 1.01 };
+
+    for (double score : scores)
+    {
+        const int renders = evaluator.getRendersToReach(score);
+        std::cout << "  score <= " << std::setprecision(3) << score << ": ";
+        if (renders < 0)
+            std::cout << "not reached\n";
+        else
+            std::cout << renders << " renders\n";
+    }
+}
+
+// Spearman rank correlation (ties get their average rank)
+static double spearmanCorrelation(const std::vector<double>& a, const std::vector<double>& b)
+{
+    auto ranks = [](const std::vector<double>& values)
+    {
+        std::vector<size_t> order(values.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [&](size_t x, size_t y) { return values[x] < values[y]; });
+
+        std::vector<double> result(values.size());
+        for (size_t i = 0; i < order.size();)
+        {
+            size_t j = i;
+            while (j + 1 < order.size() && values[order[j + 1]] == values[order[i]])
+                ++j;
+            for (size_t k = i; k <= j; ++k)
+                result[order[k]] = 0.5 * (double)(i + j);
+            i = j + 1;
+        }
+        return result;
+    };
+
+    const size_t n = std::min(a.size(), b.size());
+    if (n < 2)
+        return 0.0;
+
+    const auto ra = ranks(a);
+    const auto rb = ranks(b);
+    const double mean = 0.5 * (double)(n - 1);
+    double cov = 0.0, varA = 0.0, varB = 0.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        cov += (ra[i] - mean) * (rb[i] - mean);
+        varA += (ra[i] - mean) * (ra[i] - mean);
+        varB += (rb[i] - mean) * (rb[i] - mean);
+    }
+    return (varA > 0.0 && varB > 0.0) ? cov / std::sqrt(varA * varB) : 0.0;
+}
+
+// Re-evaluates the best screened candidates (sorted by their screening score) at the full rate,
+// together with a few complete ones spread evenly over the rest of the ranking so the reported
+// rank correlation covers the whole range rather than just the top. Returns the full-rate results.
+static std::vector<Candidate> promoteScreened(const std::vector<Candidate>& screened,
+                                              CandidateEvaluator& evaluator,
+                                              int promoteCount)
+{
+    const size_t numTop = std::min(screened.size(), (size_t)std::max(1, promoteCount));
+
+    std::vector<size_t> picked;
+    for (size_t i = 0; i < numTop; ++i)
+        picked.push_back(i);
+
+    std::vector<size_t> rest;
+    for (size_t i = numTop; i < screened.size(); ++i)
+        if (screened[i].complete)
+            rest.push_back(i);
+
+    const size_t numChecks = std::min(rest.size(), (size_t)std::max(4, promoteCount / 4));
+    for (size_t k = 0; k < numChecks; ++k)
+        picked.push_back(rest[(k * rest.size()) / numChecks]);
+
+    std::vector<KickParams> batch;
+    for (size_t i : picked)
+        batch.push_back(screened[i].params);
+    auto promoted = evaluator.evaluate(batch);
+
+    std::vector<double> screenScores, fullScores;
+    for (size_t k = 0; k < picked.size(); ++k)
+    {
+        screenScores.push_back(screened[picked[k]].score);
+        fullScores.push_back(promoted[k].score);
+    }
+
+    size_t bestIndex = 0;
+    for (size_t k = 1; k < promoted.size(); ++k)
+        if (promoted[k].score < promoted[bestIndex].score)
+            bestIndex = k;
+
+    std::cout << "Screening rank correlation (Spearman): " << std::fixed << std::setprecision(3)
+              << spearmanCorrelation(screenScores, fullScores) << " over " << picked.size() << " candidates, "
+              << spearmanCorrelation(std::vector<double>(screenScores.begin(), screenScores.begin() + (long)numTop),
+                                     std::vector<double>(fullScores.begin(), fullScores.begin() + (long)numTop))
+              << " within the top " << numTop << "; best full-rate candidate was screened #" << (picked[bestIndex] + 1) << "\n";
+
+    std::sort(promoted.begin(), promoted.end(), [](const Candidate& a, const Candidate& b) {
+        return a.score < b.score;
+    });
+    return promoted;
 }
 
 static void printTop(const std::vector<Candidate>& candidates, int topN)
@@ -210,6 +1157,177 @@ static void printTop(const std::vector<Candidate>& candidates, int topN)
     }
 }
 
+// Options of a kick_fit --targets run
+struct FitSettings
+{
+    double sampleRate = 48000.0;
+    int antialiasing = 1;
+    int numJobs = 1;
+    int numLanes = 1;
+    bool earlyRejection = true;
+    juce::String optimizer = "coordinate";
+    int renderBudget = 2500;
+    int refineIters = 80;
+    int seed = 42;
+    int numSeeds = 8;  // starting points per target
+    int bankSize = 1000; // shared renders when there is no model
+};
+
+// kick_fit --targets: fits every target in a directory (metrics JSON or WAV) from one shared bank.
+// Renders do not depend on the target, so the bank (a trained model, or bankSize random parameter
+// sets rendered once and kept as a model) is scored against every target, and each target is seeded
+// from its suggestions: the prediction and the nearest bank entries. The bank's renders are copied
+// into each target's evaluation cache, so its seeds cost no renders. Targets are then refined
+// independently, numJobs at a time with one job each, so a target's result does not depend on the
+// others or on the job count. Writes <out>/<target name>_params.json per target, or
+// <target file name>_params.json (a_wav_params.json) when two targets share a name.
+static int fitTargets(const juce::File& directory, const juce::File& outDirectory, KickInverseModel bank,
+                      const FitSettings& settings)
+{
+    struct Target
+    {
+        juce::File file;
+        juce::String outName; // without the _params.json suffix
+        KickMetrics metrics;
+        Candidate seed;
+        Candidate best;
+        int renders = 0;
+    };
+
+    std::vector<Target> targets;
+    auto files = directory.findChildFiles(juce::File::findFiles, false, "*.json;*.wav");
+    files.sort();
+    for (const auto& file : files)
+    {
+        Target target;
+        target.file = file;
+        target.outName = file.getFileNameWithoutExtension();
+        if (file.hasFileExtension("wav"))
+        {
+            target.metrics = KickAnalyzer::analyzeFile(file).metrics;
+        }
+        else
+        {
+            auto json = juce::JSON::parse(file.loadFileAsString());
+            if (json.isVoid() || json.isUndefined())
+            {
+                std::cout << "Skipping (invalid JSON): " << file.getFullPathName() << "\n";
+                continue;
+            }
+            target.metrics = KickMetrics::fromJson(json);
+        }
+        targets.push_back(std::move(target));
+    }
+
+    if (targets.empty())
+    {
+        std::cout << "Error: no target metrics (.json) or WAV files in: " << directory.getFullPathName() << "\n";
+        return 1;
+    }
+
+    // a.json and a.wav would both write a_params.json (compared ignoring case, for case-insensitive
+    // file systems), so targets sharing a name keep their extension in it
+    std::map<juce::String, int> nameCounts;
+    for (const auto& target : targets)
+        ++nameCounts[target.outName.toLowerCase()];
+    for (auto& target : targets)
+        if (nameCounts[target.outName.toLowerCase()] > 1)
+            target.outName = target.file.getFileName().replaceCharacter('.', '_');
+
+    if (!outDirectory.createDirectory())
+    {
+        std::cout << "Error: could not create output directory: " << outDirectory.getFullPathName() << "\n";
+        return 1;
+    }
+
+    EvaluationCache bankCache;
+    int bankRenders = 0;
+    if (bank.isEmpty())
+    {
+        std::mt19937 rng((uint32_t)settings.seed);
+        std::vector<KickParams> draws;
+        for (int i = 0; i < settings.bankSize; ++i)
+            draws.push_back(KickInverseModel::drawParams(rng, settings.antialiasing));
+
+        std::cout << "Rendering a bank of " << settings.bankSize << " candidates for " << targets.size() << " targets\n";
+        const KickMetrics noTarget;
+        CandidateEvaluator bankEvaluator(noTarget, settings.sampleRate, settings.numJobs);
+        bankEvaluator.setEarlyRejection(false);
+        bankEvaluator.setNumLanes(settings.numLanes);
+
+        bank.setSampleRate(settings.sampleRate);
+        for (const auto& cand : bankEvaluator.evaluate(draws))
+            bank.add(cand.params, cand.metrics);
+        bankCache = bankEvaluator.getCache();
+        bankRenders = bankEvaluator.getNumRenders();
+    }
+    else
+    {
+        std::cout << "Seeding " << targets.size() << " targets from the model's " << bank.size() << " entries\n";
+    }
+
+    std::mutex outputLock;
+    std::atomic<size_t> nextIndex { 0 };
+
+    runOnWorkers(std::min(settings.numJobs, (int)targets.size()), [&](int)
+    {
+        for (size_t i = nextIndex++; i < targets.size(); i = nextIndex++)
+        {
+            auto& target = targets[i];
+            std::ostringstream log;
+
+            CandidateEvaluator evaluator(target.metrics, settings.sampleRate, 1);
+            evaluator.setEarlyRejection(settings.earlyRejection);
+            evaluator.setNumLanes(settings.numLanes);
+            evaluator.setLog(log);
+            evaluator.getCache() = bankCache;
+
+            std::vector<KickParams> seeds;
+            for (auto params : bank.suggest(target.metrics, settings.numSeeds))
+            {
+                params.distortionAntialiasing = settings.antialiasing;
+                seeds.push_back(params);
+            }
+
+            auto seeded = evaluator.evaluate(seeds);
+            target.seed = *std::min_element(seeded.begin(), seeded.end(), [](const Candidate& a, const Candidate& b) {
+                return a.score < b.score;
+            });
+
+            target.best = target.seed;
+            if (settings.optimizer != "coordinate" || settings.refineIters > 0)
+            {
+                auto refined = refineCandidate(target.seed, evaluator, target.metrics, settings.optimizer,
+                                               settings.renderBudget, settings.refineIters, (uint32_t)settings.seed);
+                if (refined.score < target.best.score)
+                    target.best = refined;
+            }
+            target.renders = evaluator.getNumRenders();
+
+            const auto outFile = outDirectory.getChildFile(target.outName + "_params.json");
+            saveKickParamsJson(outFile, target.best.params);
+
+            const std::lock_guard<std::mutex> lock(outputLock);
+            std::cout << "\n" << target.file.getFileName() << ": seed score " << std::fixed << std::setprecision(3)
+                      << target.seed.score << " -> " << target.best.score << " (" << target.renders << " renders)"
+                      << log.str() << "Saved: " << outFile.getFullPathName() << "\n";
+        }
+    });
+
+    int totalRenders = bankRenders;
+    std::cout << "\n" << std::left << std::setw(32) << "target" << std::right << std::setw(10) << "seed"
+              << std::setw(10) << "final" << std::setw(10) << "renders" << "\n";
+    for (const auto& target : targets)
+    {
+        std::cout << std::left << std::setw(32) << target.file.getFileName() << std::right << std::fixed
+                  << std::setprecision(3) << std::setw(10) << target.seed.score << std::setw(10) << target.best.score
+                  << std::setw(10) << target.renders << "\n";
+        totalRenders += target.renders;
+    }
+    std::cout << targets.size() << " targets, " << totalRenders << " renders (" << bankRenders << " for the shared bank)\n";
+    return 0;
+}
+
 int main(int argc, char* argv[])
 {
     juce::ScopedJuceInitialiser_GUI init;
@@ -217,26 +1335,46 @@ int main(int argc, char* argv[])
     if (argc < 2)
     {
         std::cout << "Usage: kick_fit <target_metrics.json> [--target-wav target.wav] [--out params.json]"
-                     " [--iters 200] [--refine 80] [--seed 42] [--sr 48000]\n";
+                     " [--iters 200] [--refine 80] [--seed 42] [--sr 48000] [--adaa 1] [--jobs 1] [--lanes 1]"
+                     " [--optimizer coordinate|cmaes|staged|gradient] [--budget 2500] [--report-score 5,4.5] [--cache evals.json]"
+                     " [--model model.bin] [--model-seeds 8]\n"
+                     "       kick_fit --targets <dir> [--out <dir>] [--bank 1000] [--refine 80] [--seed 42] [--sr 48000] [--adaa 1]"
+                     " [--jobs 1] [--lanes 1] [--optimizer ...] [--budget 2500] [--early-reject 1] [--model model.bin] [--model-seeds 8]\n";
         return 1;
     }
 
-    juce::File targetFile(argv[1]);
-    if (!targetFile.existsAsFile())
-    {
-        std::cout << "Error: target metrics file not found\n";
-        return 1;
-    }
+    // Without a target file the options start at argv[1] (--targets)
+    const bool hasTargetFile = !juce::String(argv[1]).startsWith("--");
+    juce::File targetFile(hasTargetFile ? juce::String(argv[1]) : juce::String());
 
     int iterations = 200;
     int refineIters = 80;
     int seed = 42;
     double sampleRate = 48000.0;
+    int antialiasing = 1;
+    int numJobs = 1;
+    int numLanes = 1;
+    juce::String optimizer = "coordinate";
+    int renderBudget = 2500;
+    std::vector<double> reportScores;
     juce::File outFile;
     juce::File targetWavFile;
-    for (int i = 2; i < argc; ++i)
+    juce::File cacheFile;
+    juce::File modelFile;
+    int modelSeeds = 8;
+    juce::File targetsDirectory;
+    int bankSize = 1000;
+    bool earlyRejection = true;
+    double screenSampleRate = 0.0;
+    int promoteCount = 24;
+    juce::StringArray singleTargetOptions; // given, and not applicable to --targets runs
+    for (int i = hasTargetFile ? 2 : 1; i < argc; ++i)
     {
         juce::String arg = argv[i];
+        if (arg == "--iters" || arg == "--target-wav" || arg == "--cache" || arg == "--report-score"
+            || arg == "--screen-sr" || arg == "--promote")
+            singleTargetOptions.addIfNotAlreadyThere(arg);
+
         if (arg == "--iters" && i + 1 < argc)
             iterations = juce::String(argv[++i]).getIntValue();
         else if (arg == "--refine" && i + 1 < argc)
@@ -245,10 +1383,114 @@ int main(int argc, char* argv[])
             seed = juce::String(argv[++i]).getIntValue();
         else if (arg == "--sr" && i + 1 < argc)
             sampleRate = juce::String(argv[++i]).getDoubleValue();
+        else if (arg == "--adaa" && i + 1 < argc)
+            antialiasing = juce::String(argv[++i]).getIntValue();
+        else if (arg == "--jobs" && i + 1 < argc)
+            numJobs = juce::String(argv[++i]).getIntValue();
+        else if (arg == "--lanes" && i + 1 < argc)
+            numLanes = juce::String(argv[++i]).getIntValue();
+        else if (arg == "--optimizer" && i + 1 < argc)
+            optimizer = juce::String(argv[++i]).toLowerCase();
+        else if (arg == "--budget" && i + 1 < argc)
+            renderBudget = juce::String(argv[++i]).getIntValue();
+        else if (arg == "--report-score" && i + 1 < argc)
+        {
+            juce::StringArray scores;
+            scores.addTokens(argv[++i], ",", "");
+            for (const auto& score : scores)
+                if (score.trim().isNotEmpty())
+                    reportScores.push_back(score.getDoubleValue());
+        }
         else if (arg == "--target-wav" && i + 1 < argc)
             targetWavFile = juce::File(argv[++i]);
         else if (arg == "--out" && i + 1 < argc)
             outFile = juce::File(argv[++i]);
+        else if (arg == "--cache" && i + 1 < argc)
+            cacheFile = juce::File(argv[++i]);
+        else if (arg == "--targets" && i + 1 < argc)
+            targetsDirectory = juce::File(argv[++i]);
+        else if (arg == "--bank" && i + 1 < argc)
+            bankSize = std::max(1, juce::String(argv[++i]).getIntValue());
+        else if (arg == "--model" && i + 1 < argc)
+            modelFile = juce::File(argv[++i]);
+        else if (arg == "--model-seeds" && i + 1 < argc)
+            modelSeeds = std::max(1, juce::String(argv[++i]).getIntValue());
+        else if (arg == "--screen-sr" && i + 1 < argc)
+            screenSampleRate = juce::String(argv[++i]).getDoubleValue();
+        else if (arg == "--promote" && i + 1 < argc)
+            promoteCount = juce::String(argv[++i]).getIntValue();
+        else if (arg == "--early-reject" && i + 1 < argc)
+            earlyRejection = juce::String(argv[++i]).getIntValue() != 0;
+    }
+
+    if (optimizer != "coordinate" && optimizer != "cmaes" && optimizer != "staged" && optimizer != "gradient")
+    {
+        std::cout << "Error: unknown optimizer '" << optimizer << "' (expected coordinate, cmaes, staged or gradient)\n";
+        return 1;
+    }
+
+    // A trained model (kick_train) replaces the rule-based starting point and the seed search
+    KickInverseModel model;
+    if (modelFile != juce::File())
+    {
+        if (!model.load(modelFile) || model.isEmpty())
+        {
+            std::cout << "Error: could not load model (missing, damaged or another parameter schema): "
+                      << modelFile.getFullPathName() << "\n";
+            return 1;
+        }
+        // Its metrics (and so its suggestions) only match renders at the rate it was trained at
+        if (model.getSampleRate() != sampleRate)
+        {
+            std::cout << "Error: model was rendered at " << model.getSampleRate() << " Hz, not the --sr of "
+                      << sampleRate << " Hz (train it again with kick_train --sr): " << modelFile.getFullPathName() << "\n";
+            return 1;
+        }
+        std::cout << "Loaded model with " << model.size() << " entries rendered at " << model.getSampleRate()
+                  << " Hz from: " << modelFile.getFullPathName() << "\n";
+    }
+
+    // --jobs 0 uses every core
+    if (numJobs <= 0)
+        numJobs = juce::SystemStats::getNumCpus();
+
+    if (targetsDirectory != juce::File())
+    {
+        if (!targetsDirectory.isDirectory())
+        {
+            std::cout << "Error: targets directory not found: " << targetsDirectory.getFullPathName() << "\n";
+            return 1;
+        }
+
+        // The bank replaces the grid and random seeds, and each target gets a fresh evaluator
+        if (!singleTargetOptions.isEmpty())
+        {
+            std::cout << "Error: " << singleTargetOptions.joinIntoString(", ")
+                      << " only apply to single-target runs, not --targets\n";
+            return 1;
+        }
+
+        FitSettings settings;
+        settings.sampleRate = sampleRate;
+        settings.antialiasing = std::max(0, std::min(antialiasing, 2));
+        settings.numJobs = numJobs;
+        settings.numLanes = numLanes;
+        settings.earlyRejection = earlyRejection;
+        settings.optimizer = optimizer;
+        settings.renderBudget = renderBudget;
+        settings.refineIters = refineIters;
+        settings.seed = seed;
+        settings.numSeeds = modelSeeds;
+        settings.bankSize = bankSize;
+
+        const juce::File outDirectory = outFile != juce::File() ? outFile : targetsDirectory.getChildFile("fitted");
+        return fitTargets(targetsDirectory, outDirectory, std::move(model), settings);
+    }
+
+    if (!targetFile.existsAsFile())
+    {
+        std::cout << "Error: target metrics file not found\n";
+        return 1;
     }
 
     KickMetrics target;
@@ -270,7 +1512,9 @@ int main(int argc, char* argv[])
         target = KickMetrics::fromJson(targetJson);
     }
 
-    KickParams base = baseFromTarget(target);
+    KickParams base = model.isEmpty() ? baseFromTarget(target) : model.predict(target);
+    // Aliasing from the shapers lands in the click band the score looks at, so fit with ADAA on
+    base.distortionAntialiasing = std::max(0, std::min(antialiasing, 2));
 
     std::mt19937 rng((uint32_t)seed);
     std::uniform_real_distribution<float> dist01(0.0f, 1.0f);
@@ -279,70 +1523,155 @@ int main(int argc, char* argv[])
     std::vector<Candidate> candidates;
     candidates.reserve((size_t)iterations + 300);
 
-    KickRenderEngine engine;
-    engine.prepare(sampleRate);
-    juce::AudioBuffer<float> renderBuffer;
-
-    // Coarse grid over the most impactful parameters (pitch + decay + click + drive).
-    const std::array<float, 3> mul = { 0.75f, 1.0f, 1.25f };
-    const std::array<float, 3> clickVals = { 0.15f, 0.5f, 0.85f };
-    const std::array<float, 3> driveVals = { 0.15f, 0.5f, 0.85f };
+    CandidateEvaluator evaluator(target, sampleRate, numJobs);
+    evaluator.setEarlyRejection(earlyRejection);
+    evaluator.setNumLanes(numLanes);
+    std::cout << "Evaluating with " << evaluator.getNumJobs() << " job(s)";
+    if (evaluator.getNumLanes() > 1)
+        std::cout << ", " << evaluator.getNumLanes() << " lanes per render";
+    std::cout << "\n";
 
-    for (float mStart : mul)
-        for (float mTau : mul)
-            for (float mDecay : mul)
-                for (float click : clickVals)
-                    for (float drive : driveVals)
-                    {
-                        KickParams p = base;
-                        p.pitchStartHz = clampFloat(p.pitchStartHz * mStart, 20.0f, 500.0f);
-                        p.pitchTauMs = clampFloat(p.pitchTauMs * mTau, 1.0f, 100.0f);
-                        p.t12Ms = clampFloat(p.t12Ms * mDecay, 1.0f, 50.0f);
-                        p.t24Ms = clampFloat(p.t24Ms * mDecay, 5.0f, 200.0f);
-                        p.clickLevel = click;
-                        p.drive = drive;
-                        candidates.push_back(evaluateCandidate(p, target, engine, renderBuffer, sampleRate));
-                    }
+    if (cacheFile != juce::File())
+    {
+        if (evaluator.getCache().load(cacheFile, target, sampleRate))
+            std::cout << "Loaded " << evaluator.getCache().size() << " cached evaluations from: " << cacheFile.getFullPathName() << "\n";
+        else if (cacheFile.existsAsFile())
+            std::cout << "Ignoring evaluation cache (other sample rate or parameter schema): " << cacheFile.getFullPathName() << "\n";
+    }
 
-    for (int i = 0; i < iterations; ++i)
-    {
-        KickParams p = base;
-        p.pitchStartHz = clampFloat(p.pitchStartHz * distScale(rng), 20.0f, 500.0f);
-        p.pitchEndHz = clampFloat(p.pitchEndHz * distScale(rng), 20.0f, 200.0f);
-        p.pitchTauMs = clampFloat(p.pitchTauMs * distScale(rng), 1.0f, 100.0f);
-        p.attackMs = clampFloat(p.attackMs * distScale(rng), 0.0f, 50.0f);
-        p.t12Ms = clampFloat(p.t12Ms * distScale(rng), 1.0f, 50.0f);
-        p.t24Ms = clampFloat(p.t24Ms * distScale(rng), 5.0f, 200.0f);
-        p.tailMsToMinus60Db = clampFloat(p.tailMsToMinus60Db * distScale(rng), 10.0f, 500.0f);
-        p.clickLevel = clampFloat(dist01(rng), 0.0f, 1.0f);
-        p.bodyLevel = clampFloat(dist01(rng), 0.1f, 1.0f);
-        p.drive = clampFloat(dist01(rng), 0.0f, 1.0f);
-        p.asymmetry = clampFloat(dist01(rng), 0.0f, 1.0f);
-        p.clickDecayMs = clampFloat(p.clickDecayMs * distScale(rng), 1.0f, 20.0f);
-        p.clickHPFHz = clampFloat(p.clickHPFHz * distScale(rng), 500.0f, 10000.0f);
-        p.outputHPFHz = clampFloat(p.outputHPFHz * distScale(rng), 20.0f, 200.0f);
-        p.bodyOscType = (dist01(rng) > 0.5f) ? 1 : 0;
-        p.distortionType = (int)std::floor(dist01(rng) * 3.0f);
-        p.outputGainDb = clampFloat(base.outputGainDb + (dist01(rng) - 0.5f) * 6.0f, -12.0f, 12.0f);
-
-        candidates.push_back(evaluateCandidate(p, target, engine, renderBuffer, sampleRate));
-    }
-
-    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
-        return a.score < b.score;
-    });
+    // With --screen-sr the seeds are ranked at a reduced rate and only the best are rendered again
+    // at the full rate
+    std::unique_ptr<CandidateEvaluator> screenEvaluator;
+    if (screenSampleRate > 0.0 && screenSampleRate < sampleRate)
+    {
+        screenEvaluator = std::make_unique<CandidateEvaluator>(target, screenSampleRate, numJobs);
+        screenEvaluator->setEarlyRejection(earlyRejection);
+        screenEvaluator->setNumLanes(numLanes);
+        std::cout << "Screening seeds at " << screenSampleRate << " Hz, promoting the top " << promoteCount << "\n";
+    }
+    CandidateEvaluator& seedEvaluator = screenEvaluator != nullptr ? *screenEvaluator : evaluator;
 
-    printTop(candidates, 10);
+    std::vector<KickParams> batch;
+    constexpr int numShown = 10;
 
-    if (!candidates.empty() && refineIters > 0)
+    auto sortCandidates = [&candidates]()
     {
-        std::cout << "\nRefining best candidate (" << refineIters << " iters)...\n";
-        auto refined = refineCoordinateDescent(candidates.front(), target, engine, renderBuffer, sampleRate, refineIters);
-        candidates.push_back(refined);
         std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
             return a.score < b.score;
         });
-        printTop(candidates, 10);
+    };
+
+    if (!model.isEmpty())
+    {
+        // The model's prediction and nearest entries stand in for the grid and random seeds
+        for (auto params : model.suggest(target, modelSeeds))
+        {
+            params.distortionAntialiasing = base.distortionAntialiasing;
+            batch.push_back(params);
+        }
+        std::cout << "Seeding from the model: " << batch.size() << " candidates\n";
+
+        for (auto& cand : seedEvaluator.evaluate(batch))
+            candidates.push_back(std::move(cand));
+        sortCandidates();
+    }
+    else
+    {
+        // Coarse grid over the most impactful parameters (pitch + decay + click + drive).
+        const std::array<float, 3> mul = { 0.75f, 1.0f, 1.25f };
+        const std::array<float, 3> clickVals = { 0.15f, 0.5f, 0.85f };
+        const std::array<float, 3> driveVals = { 0.15f, 0.5f, 0.85f };
+
+        for (float mStart : mul)
+            for (float mTau : mul)
+                for (float mDecay : mul)
+                    for (float click : clickVals)
+                        for (float drive : driveVals)
+                        {
+                            KickParams p = base;
+                            p.pitchStartHz *= mStart;
+                            p.pitchTauMs *= mTau;
+                            p.t12Ms *= mDecay;
+                            p.t24Ms *= mDecay;
+                            p.clickLevel = click;
+                            p.drive = drive;
+                            batch.push_back(p.clamped());
+                        }
+
+        for (auto& cand : seedEvaluator.evaluate(batch))
+            candidates.push_back(std::move(cand));
+        sortCandidates();
+
+        // Random candidates only need a full analysis while they could still enter the top-10 table
+        // (or, when screening, the promoted set)
+        const size_t numKept = (size_t)(screenEvaluator != nullptr ? std::max(promoteCount, numShown) : numShown);
+        const double randomRejectAbove = candidates.size() >= numKept
+                                             ? candidates[numKept - 1].score
+                                             : std::numeric_limits<double>::infinity();
+
+        // Random candidates are all drawn up front, in order, so the set only depends on --seed. Each
+        // draw is clamped to the schema ranges.
+        const int numOscTypes = (int)KickParameterSchema::specs[KickParameterSchema::bodyOscType].maxValue + 1;
+        const int numDistortionTypes = (int)KickParameterSchema::specs[KickParameterSchema::distortionType].maxValue + 1;
+        batch.clear();
+        for (int i = 0; i < iterations; ++i)
+        {
+            KickParams p = base;
+            p.pitchStartHz *= distScale(rng);
+            p.pitchEndHz *= distScale(rng);
+            p.pitchTauMs *= distScale(rng);
+            p.attackMs *= distScale(rng);
+            p.t12Ms *= distScale(rng);
+            p.t24Ms *= distScale(rng);
+            p.tailMsToMinus60Db *= distScale(rng);
+            p.clickLevel = dist01(rng);
+            p.bodyLevel = dist01(rng);
+            p.drive = dist01(rng);
+            p.asymmetry = dist01(rng);
+            p.clickDecayMs *= distScale(rng);
+            p.clickHPFHz *= distScale(rng);
+            p.outputHPFHz *= distScale(rng);
+            p.bodyOscType = std::min(numOscTypes - 1, (int)(dist01(rng) * (float)numOscTypes));
+            p.distortionType = std::min(numDistortionTypes - 1, (int)(dist01(rng) * (float)numDistortionTypes));
+            p.outputGainDb = base.outputGainDb + (dist01(rng) - 0.5f) * 6.0f;
+
+            batch.push_back(p.clamped());
+        }
+
+        for (auto& cand : seedEvaluator.evaluate(batch, randomRejectAbove))
+            candidates.push_back(std::move(cand));
+        sortCandidates();
+    }
+
+    if (screenEvaluator != nullptr && !candidates.empty())
+        candidates = promoteScreened(candidates, evaluator, promoteCount);
+
+    printTop(candidates, numShown);
+
+    if (!candidates.empty() && (optimizer != "coordinate" || refineIters > 0))
+    {
+        candidates.push_back(refineCandidate(candidates.front(), evaluator, target, optimizer, renderBudget,
+                                             refineIters, (uint32_t)seed));
+        sortCandidates();
+        printTop(candidates, numShown);
+    }
+
+    if (!candidates.empty())
+        printRenderReport(optimizer.toRawUTF8(), evaluator, candidates.front().score, reportScores);
+    if (screenEvaluator != nullptr)
+    {
+        std::cout << "Screening at " << screenSampleRate << " Hz:\n";
+        screenEvaluator->printEvaluationReport();
+        std::cout << "Full rate at " << sampleRate << " Hz:\n";
+    }
+    evaluator.printEvaluationReport();
+
+    if (cacheFile != juce::File())
+    {
+        if (evaluator.getCache().save(cacheFile, sampleRate))
+            std::cout << "Saved " << evaluator.getCache().size() << " cached evaluations to: " << cacheFile.getFullPathName() << "\n";
+        else
+            std::cout << "Error: could not write evaluation cache: " << cacheFile.getFullPathName() << "\n";
     }
 
     if (!candidates.empty())
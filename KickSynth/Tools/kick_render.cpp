@@ -7,7 +7,7 @@ int main(int argc, char* argv[])
 
     if (argc < 3)
     {
-        std::cout << "Usage: kick_render <params.json> <output.wav> [--sr 48000] [--length-ms 500] [--velocity 1.0]\n";
+        std::cout << "Usage: kick_render <params.json> <output.wav> [--sr 48000] [--length-ms 500] [--velocity 1.0] [--seed 1]\n";
         return 1;
     }
 
@@ -23,6 +23,7 @@ int main(int argc, char* argv[])
     double sampleRate = 48000.0;
     double lengthMs = 500.0;
     float velocity = 1.0f;
+    int seed = -1;
 
     for (int i = 3; i < argc; ++i)
     {
@@ -33,9 +34,13 @@ int main(int argc, char* argv[])
             lengthMs = juce::String(argv[++i]).getDoubleValue();
         else if (arg == "--velocity" && i + 1 < argc)
             velocity = juce::String(argv[++i]).getFloatValue();
+        else if (arg == "--seed" && i + 1 < argc)
+            seed = juce::String(argv[++i]).getIntValue();
     }
 
     auto params = loadKickParamsJson(paramsFile);
+    if (seed >= 0)
+        params.noiseSeed = seed;
 
     int numSamples = (int)std::round(sampleRate * (lengthMs / 1000.0));
     numSamples = std::max(1, numSamples);
@@ -0,0 +1,100 @@
+#include "KickInverseModel.h"
+#include "KickMetrics.h"
+#include "KickRenderEngine.h"
+#include "KickParams.h"
+#include "WorkerPool.h"
+#include <iostream>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+// Renders a random sample of parameter sets, analyses each render and saves the pairs as a
+// KickInverseModel for kick_fit --model.
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI init;
+
+    juce::File outFile;
+    int count = 4000;
+    int seed = 1;
+    double sampleRate = 48000.0;
+    int antialiasing = 1;
+    int numJobs = 1;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        juce::String arg = argv[i];
+        if (arg == "--out" && i + 1 < argc)
+            outFile = juce::File(argv[++i]);
+        else if (arg == "--count" && i + 1 < argc)
+            count = juce::String(argv[++i]).getIntValue();
+        else if (arg == "--seed" && i + 1 < argc)
+            seed = juce::String(argv[++i]).getIntValue();
+        else if (arg == "--sr" && i + 1 < argc)
+            sampleRate = juce::String(argv[++i]).getDoubleValue();
+        else if (arg == "--adaa" && i + 1 < argc)
+            antialiasing = juce::String(argv[++i]).getIntValue();
+        else if (arg == "--jobs" && i + 1 < argc)
+            numJobs = juce::String(argv[++i]).getIntValue();
+    }
+
+    if (outFile == juce::File() || count <= 0)
+    {
+        std::cout << "Usage: kick_train --out model.bin [--count 4000] [--seed 1] [--sr 48000] [--adaa 1] [--jobs 1]\n";
+        return 1;
+    }
+
+    // --jobs 0 uses every core
+    if (numJobs <= 0)
+        numJobs = juce::SystemStats::getNumCpus();
+    numJobs = std::min(numJobs, count);
+
+    // Drawn up front, so the model only depends on --seed
+    std::mt19937 rng((uint32_t)seed);
+    std::vector<KickParams> samples;
+    for (int i = 0; i < count; ++i)
+        samples.push_back(KickInverseModel::drawParams(rng, std::max(0, std::min(antialiasing, 2))));
+
+    std::cout << "Rendering " << count << " kicks at " << sampleRate << " Hz with " << numJobs << " job(s)\n";
+
+    std::vector<KickMetrics> metrics(samples.size());
+    std::atomic<size_t> nextIndex { 0 };
+    std::atomic<int> numDone { 0 };
+
+    runOnWorkers(numJobs, [&](int)
+    {
+        KickRenderEngine engine;
+        engine.prepare(sampleRate);
+        engine.setSkipSilentTail(true);
+        juce::AudioBuffer<float> buffer;
+        AnalysisWorkspace analysis;
+
+        for (size_t i = nextIndex++; i < samples.size(); i = nextIndex++)
+        {
+            buffer.setSize(1, KickRenderEngine::getRenderLength(samples[i], sampleRate), false, false, true);
+            engine.render(samples[i], 1.0f, buffer);
+            metrics[i] = KickAnalyzer::analyzeBuffer(buffer, sampleRate, analysis).metrics;
+
+            const int done = ++numDone;
+            if (done % std::max(1, count / 10) == 0)
+                std::cout << "  " << done << " / " << count << "\n";
+        }
+    });
+
+    KickInverseModel model;
+    model.setSampleRate(sampleRate);
+    for (size_t i = 0; i < samples.size(); ++i)
+        model.add(samples[i], metrics[i]);
+
+    if (!model.save(outFile))
+    {
+        std::cout << "Error: could not write model: " << outFile.getFullPathName() << "\n";
+        return 1;
+    }
+
+    std::cout << "Saved " << model.size() << " entries to: " << outFile.getFullPathName() << "\n";
+    return 0;
+}
@@ -0,0 +1,29 @@
+#include "SharedResources.h"
+
+SharedResources::SharedResources()
+{
+}
+
+SharedResources::~SharedResources()
+{
+    // Last holder gone: stop the pool before anything it might still touch is destroyed
+    const juce::ScopedLock sl(poolLock);
+    if (workerPool != nullptr)
+    {
+        workerPool->removeAllJobs(true, 5000);
+        workerPool.reset();
+    }
+}
+
+juce::ThreadPool& SharedResources::getWorkerPool()
+{
+    const juce::ScopedLock sl(poolLock);
+    if (workerPool == nullptr)
+        workerPool = std::make_unique<juce::ThreadPool>(getNumWorkerThreads());
+    return *workerPool;
+}
+
+int SharedResources::getNumWorkerThreads()
+{
+    return juce::jlimit(1, 4, juce::SystemStats::getNumCpus() / 2);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include <memory>
+#include <typeindex>
+#include <utility>
+
+/**
+ * SharedResources - Process-wide resources shared by every plugin instance
+ *
+ * Hold it through juce::SharedResourcePointer<SharedResources>: the first holder creates it and the
+ * last one to let go destroys it, so it lives exactly as long as some instance needs it. It owns
+ * - immutable lookup tables (interpolation kernels, ...), built once per (type, key) and handed out
+ *   as shared_ptr<const Table>; a table is freed when its last user releases it
+ * - one bounded worker pool for background jobs (editor previews, caches), so the number of threads
+ *   stays fixed however many instances are open
+ *
+ * Both lock and may allocate: use them from prepare() and the message or worker threads, never from
+ * the audio thread. Jobs added to the pool must not rely on the adding object outliving them; the
+ * pool is drained (running jobs are asked to exit) before the last holder's destructor returns.
+ */
+class SharedResources
+{
+public:
+    SharedResources();
+    ~SharedResources();
+
+    // Table registered under key, built by create() if no instance holds one yet
+    template <typename Table, typename Create>
+    std::shared_ptr<const Table> getTable(const juce::String& key, Create&& create)
+    {
+        const juce::ScopedLock sl(tableLock);
+        auto& entry = tables[{ std::type_index(typeid(Table)), key }];
+        if (auto existing = entry.lock())
+            return std::static_pointer_cast<const Table>(existing);
+
+        std::shared_ptr<const Table> table = std::make_shared<Table>(create());
+        entry = table;
+        return table;
+    }
+
+    // Shared background pool, started on first use
+    juce::ThreadPool& getWorkerPool();
+
+    // Threads in the worker pool: half the cores, between 1 and 4
+    static int getNumWorkerThreads();
+
+private:
+    juce::CriticalSection tableLock;
+    std::map<std::pair<std::type_index, juce::String>, std::weak_ptr<const void>> tables;
+
+    juce::CriticalSection poolLock;
+    std::unique_ptr<juce::ThreadPool> workerPool;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharedResources)
+};